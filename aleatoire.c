@@ -0,0 +1,323 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "aleatoire.h"
+#include "parallele.h"
+#include "taches.h"
+
+#define ALEA_BLOC 256 /* nombres tirés d'un coup par genereForme, multiple de ALEA_VOIES */
+
+/**
+ * @brief Morceau de points à tirer, argument d'une tâche
+ *
+ */
+typedef struct{
+    const Tirage *tirage; /* la forme */
+    double *x; /* abscisses des points du morceau */
+    double *y; /* ordonnées */
+    int n; /* nombre de points du morceau */
+    uint64_t graine; /* la graine */
+    uint64_t flux; /* flux du morceau */
+} MorceauAlea;
+
+///////////////////////////
+// Fonctions générateurs //
+///////////////////////////
+
+/**
+ * @brief Avance un état de splitmix64 et renvoie le nombre suivant, pour initialiser xoshiro
+ */
+static uint64_t splitmix64(uint64_t *etat){
+    uint64_t z = (*etat += 0x9e3779b97f4a7c15u);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9u;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebu;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Rotation à gauche de k bits
+ */
+static inline uint64_t rotation(uint64_t x, int k){
+    return (x << k) | (x >> (64 - k));
+}
+
+void initGenerateur(Generateur *generateur, uint64_t graine, uint64_t flux){
+    // La graine est mélangée avant d'y ajouter le flux : des graines voisines ne donnent pas des
+    // flux décalés les uns des autres
+    uint64_t etat = graine;
+    etat = splitmix64(&etat) + flux * 0xd1342543de82ef95u;
+
+    for (int v = 0; v < ALEA_VOIES; v++){
+        for (int k = 0; k < 4; k++){
+            generateur->s[k][v] = splitmix64(&etat);
+        }
+    }
+    generateur->reste = 0;
+}
+
+void remplitAleatoire(Generateur *generateur, uint64_t *sortie, int n){
+    uint64_t s0[ALEA_VOIES], s1[ALEA_VOIES], s2[ALEA_VOIES], s3[ALEA_VOIES];
+    memcpy(s0, generateur->s[0], sizeof(s0));
+    memcpy(s1, generateur->s[1], sizeof(s1));
+    memcpy(s2, generateur->s[2], sizeof(s2));
+    memcpy(s3, generateur->s[3], sizeof(s3));
+
+    // Les voies sont indépendantes : la boucle intérieure est vectorisée
+    for (int i = 0; i < n; i += ALEA_VOIES){
+        for (int v = 0; v < ALEA_VOIES; v++){
+            sortie[i + v] = rotation(s1[v] * 5, 7) * 9;
+
+            uint64_t t = s1[v] << 17;
+            s2[v] ^= s0[v];
+            s3[v] ^= s1[v];
+            s1[v] ^= s2[v];
+            s0[v] ^= s3[v];
+            s2[v] ^= t;
+            s3[v] = rotation(s3[v], 45);
+        }
+    }
+
+    memcpy(generateur->s[0], s0, sizeof(s0));
+    memcpy(generateur->s[1], s1, sizeof(s1));
+    memcpy(generateur->s[2], s2, sizeof(s2));
+    memcpy(generateur->s[3], s3, sizeof(s3));
+}
+
+uint64_t graineParDefaut(void){
+    const char *texte = getenv("ENVELOPPE_GRAINE");
+    if (texte && *texte){
+        return strtoull(texte, NULL, 0);
+    }
+
+    struct timespec t;
+    clock_gettime(CLOCK_REALTIME, &t);
+    return (uint64_t) t.tv_sec * 1000000000u + t.tv_nsec;
+}
+
+///////////////////////
+// Fonctions tirages //
+///////////////////////
+
+void initTirage(Tirage *tirage){
+    tirage->forme = FORME_CARRE;
+    tirage->rayon = 0;
+    tirage->centre.x = tirage->centre.y = 0;
+    tirage->nbPixel = 0;
+    tirage->cumul = NULL;
+    tirage->demi = NULL;
+    tirage->capacite = 0;
+    tirage->guide = NULL;
+    tirage->bitsGuide = 0;
+    tirage->capaciteGuide = 0;
+}
+
+/**
+ * @brief Renvoie la partie entière de la racine carrée de v
+ */
+static int racineEntiere(long long v){
+    long long m = (long long) sqrt((double) v);
+    while (m * m > v){
+        m--;
+    }
+    while ((m + 1) * (m + 1) <= v){
+        m++;
+    }
+    return (int) m;
+}
+
+void prepareTirage(Tirage *tirage, int forme, int R, Point centre){
+    tirage->forme = forme;
+    tirage->rayon = R;
+    tirage->centre = centre;
+
+    if (forme != FORME_CERCLE){
+        tirage->nbPixel = 4 * (uint64_t) R * R;
+        return;
+    }
+
+    // Les 2R lignes du disque, de c - R à c + R - 1, comme les candidats de getPoint
+    int nbLigne = 2 * R;
+    if (nbLigne + 1 > tirage->capacite){
+        uint64_t *cumul = (uint64_t *) realloc(tirage->cumul, (nbLigne + 1) * sizeof(uint64_t));
+        int *demi = (int *) realloc(tirage->demi, (nbLigne + 1) * sizeof(int));
+        if (!cumul || !demi){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        tirage->cumul = cumul;
+        tirage->demi = demi;
+        tirage->capacite = nbLigne + 1;
+    }
+
+    tirage->cumul[0] = 0;
+    for (int k = 0; k < nbLigne; k++){
+        long long dy = k - R;
+        int m = racineEntiere((long long) R * R - dy * dy);
+        tirage->demi[k] = m;
+        tirage->cumul[k + 1] = tirage->cumul[k] + m + ((m < R - 1) ? m : R - 1) + 1;
+    }
+    tirage->nbPixel = tirage->cumul[nbLigne];
+
+    // Au moins autant de cases que de lignes : une case couvre en moyenne moins d'une ligne
+    int bits = 1;
+    while ((1 << bits) < nbLigne){
+        bits++;
+    }
+    int nbCase = 1 << bits;
+    if (nbCase > tirage->capaciteGuide){
+        int *guide = (int *) realloc(tirage->guide, nbCase * sizeof(int));
+        if (!guide){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        tirage->guide = guide;
+        tirage->capaciteGuide = nbCase;
+    }
+    tirage->bitsGuide = bits;
+
+    // La case b reçoit les nombres u de [b 2^(64 - bits), (b + 1) 2^(64 - bits)[, dont le rang
+    // (u nbPixel) >> 64 est au moins (b nbPixel) >> bits
+    int ligne = 0;
+    for (int b = 0; b < nbCase; b++){
+        uint64_t premier = (uint64_t) (((unsigned __int128) b * tirage->nbPixel) >> bits);
+        while (tirage->cumul[ligne + 1] <= premier){
+            ligne++;
+        }
+        tirage->guide[b] = ligne;
+    }
+}
+
+/**
+ * @brief Renvoie le pixel du disque tiré par le nombre u : son rang est (u nbPixel) >> 64, et
+ * sa ligne est cherchée à partir de celle que donne la table de guidage
+ */
+static inline Point pixelDisque(const Tirage *tirage, uint64_t u){
+    const uint64_t *cumul = tirage->cumul;
+    uint64_t k = (uint64_t) (((unsigned __int128) u * tirage->nbPixel) >> 64);
+    int ligne = tirage->guide[u >> (64 - tirage->bitsGuide)];
+    while (cumul[ligne + 1] <= k){
+        ligne++;
+    }
+
+    Point P;
+    P.x = tirage->centre.x - tirage->demi[ligne] + (double) (k - cumul[ligne]);
+    P.y = tirage->centre.y - tirage->rayon + ligne;
+    return P;
+}
+
+Point tirePoint(Generateur *generateur, const Tirage *tirage){
+    if (tirage->forme == FORME_CERCLE){
+        return pixelDisque(tirage, aleatoire64(generateur));
+    }
+
+    // Carré : les 32 bits de poids fort donnent l'abscisse, ceux de poids faible l'ordonnée
+    uint64_t u = aleatoire64(generateur);
+    uint64_t cote = 2 * (uint64_t) tirage->rayon;
+    Point P;
+    P.x = tirage->centre.x - tirage->rayon + (double) (((u >> 32) * cote) >> 32);
+    P.y = tirage->centre.y - tirage->rayon + (double) (((u & 0xffffffffu) * cote) >> 32);
+    return P;
+}
+
+void libereTirage(Tirage *tirage){
+    free(tirage->cumul);
+    free(tirage->demi);
+    free(tirage->guide);
+    initTirage(tirage);
+}
+
+/**
+ * @brief Tire les points d'un morceau, par blocs de ALEA_BLOC nombres
+ */
+static void tireMorceau(void *arg){
+    MorceauAlea *morceau = (MorceauAlea *) arg;
+    const Tirage *tirage = morceau->tirage;
+    uint64_t bloc[ALEA_BLOC];
+
+    Generateur generateur;
+    initGenerateur(&generateur, morceau->graine, morceau->flux);
+
+    double x0 = tirage->centre.x - tirage->rayon;
+    double y0 = tirage->centre.y - tirage->rayon;
+    uint64_t cote = 2 * (uint64_t) tirage->rayon;
+
+    for (int debut = 0; debut < morceau->n; debut += ALEA_BLOC){
+        int n = (morceau->n - debut < ALEA_BLOC) ? morceau->n - debut : ALEA_BLOC;
+        remplitAleatoire(&generateur, bloc, ALEA_BLOC);
+
+        double *x = morceau->x + debut;
+        double *y = morceau->y + debut;
+        if (tirage->forme == FORME_CERCLE){
+            for (int i = 0; i < n; i++){
+                Point P = pixelDisque(tirage, bloc[i]);
+                x[i] = P.x;
+                y[i] = P.y;
+            }
+        }
+        else{
+            // Sans branche ni rejet : vectorisée
+            for (int i = 0; i < n; i++){
+                x[i] = x0 + (double) (((bloc[i] >> 32) * cote) >> 32);
+                y[i] = y0 + (double) (((bloc[i] & 0xffffffffu) * cote) >> 32);
+            }
+        }
+    }
+}
+
+void genereForme(NuagePoints *nuage, int nbPoint, int forme, int R, Point centre, uint64_t graine, int nbThread){
+    if (nbPoint <= 0){
+        return;
+    }
+    if (nbThread <= 0){
+        nbThread = nbCoeurs();
+    }
+
+    // Les points sont écrits directement dans les tableaux du nuage
+    int nb = nuage->nbPoint + nbPoint;
+    if (nb > nuage->capacite){
+        double *x = (double *) realloc(nuage->x, nb * sizeof(double));
+        double *y = (double *) realloc(nuage->y, nb * sizeof(double));
+        if (!x || !y){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        nuage->x = x;
+        nuage->y = y;
+        nuage->capacite = nb;
+    }
+
+    Tirage tirage;
+    initTirage(&tirage);
+    prepareTirage(&tirage, forme, R, centre);
+
+    int nbMorceau = (nbPoint + ALEA_MORCEAU - 1) / ALEA_MORCEAU;
+    MorceauAlea *morceaux = (MorceauAlea *) malloc(nbMorceau * sizeof(MorceauAlea));
+    PoolTaches *pool = creePoolTaches(nbThread);
+    if (!morceaux || !pool){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    GroupeTaches groupe;
+    initGroupe(&groupe);
+    for (int k = 0; k < nbMorceau; k++){
+        MorceauAlea *morceau = morceaux + k;
+        int debut = k * ALEA_MORCEAU;
+        morceau->tirage = &tirage;
+        morceau->x = nuage->x + nuage->nbPoint + debut;
+        morceau->y = nuage->y + nuage->nbPoint + debut;
+        morceau->n = (nbPoint - debut < ALEA_MORCEAU) ? nbPoint - debut : ALEA_MORCEAU;
+        morceau->graine = graine;
+        morceau->flux = k;
+        lanceTache(pool, &groupe, tireMorceau, morceau);
+    }
+    attendsGroupe(pool, &groupe);
+
+    detruitPoolTaches(pool);
+    free(morceaux);
+    libereTirage(&tirage);
+    nuage->nbPoint = nb;
+}
@@ -0,0 +1,152 @@
+#ifndef ALEATOIRE_H
+#define ALEATOIRE_H
+
+#include <stdint.h>
+
+#include "enveloppe.h"
+
+/*
+ * Tirages aléatoires reproductibles, sans rand() ni état global. Un générateur est un flux de
+ * xoshiro256** fait de ALEA_VOIES générateurs entrelacés, avancés ensemble par une boucle que le
+ * compilateur vectorise ; il est entièrement déterminé par sa graine et son numéro de flux, si
+ * bien que chaque thread peut avoir le sien. Les points sont tirés directement dans leur forme,
+ * sans rejet, avec la même loi que getPoint : uniforme sur les pixels [c - R, c + R[ du carré, ou
+ * sur ceux de ce carré qui sont dans le disque de rayon R.
+ */
+
+#define ALEA_VOIES 8 /* générateurs entrelacés d'un flux */
+#define ALEA_MORCEAU 65536 /* points tirés par un même flux dans genereForme */
+
+/* Formes des tirages, comme pour getPoint */
+#define FORME_CERCLE 1
+#define FORME_CARRE  2
+
+/**
+ * @brief Flux de nombres aléatoires
+ *
+ */
+typedef struct{
+    uint64_t s[4][ALEA_VOIES]; /* les états des générateurs entrelacés */
+    uint64_t tampon[ALEA_VOIES]; /* derniers nombres tirés */
+    int reste; /* nombres du tampon pas encore rendus */
+} Generateur;
+
+/**
+ * @brief Forme préparée pour des tirages sans rejet. Pour le disque, les lignes de pixels sont
+ * comptées : un pixel est tiré par son rang parmi tous les pixels du disque, et sa ligne est
+ * trouvée par une table de guidage (les bits de poids fort du nombre tiré donnent une ligne
+ * d'où avancer de quelques lignes au plus)
+ *
+ */
+typedef struct{
+    int forme; /* FORME_CERCLE ou FORME_CARRE */
+    int rayon; /* rayon R */
+    Point centre; /* centre de la forme */
+    uint64_t nbPixel; /* nombre de pixels de la forme */
+    uint64_t *cumul; /* disque : pixels des lignes précédant chaque ligne, de y = c - R à c + R - 1 */
+    int *demi; /* disque : la ligne k va de c - demi[k] à c + min(demi[k], R - 1) */
+    int capacite; /* lignes allouées */
+    int *guide; /* disque : guide[b] est la ligne du premier rang tiré par les nombres de bits de poids fort b */
+    int bitsGuide; /* la table de guidage a 2^bitsGuide cases */
+    int capaciteGuide; /* cases allouées */
+} Tirage;
+
+///////////////////////////
+// Fonctions générateurs //
+///////////////////////////
+
+/**
+ * @brief Prépare un générateur. Deux numéros de flux donnent deux suites indépendantes
+ *
+ * @param generateur Le générateur
+ * @param graine La graine
+ * @param flux Numéro du flux (par exemple celui du thread)
+ */
+void initGenerateur(Generateur *generateur, uint64_t graine, uint64_t flux);
+
+/**
+ * @brief Tire n nombres de 64 bits, ALEA_VOIES à la fois
+ *
+ * @param generateur Le générateur
+ * @param sortie Les nombres tirés
+ * @param n Nombre de nombres, multiple de ALEA_VOIES
+ */
+void remplitAleatoire(Generateur *generateur, uint64_t *sortie, int n);
+
+/**
+ * @brief Renvoie la graine de la variable d'environnement ENVELOPPE_GRAINE si elle est définie,
+ * sinon une graine tirée de l'heure
+ */
+uint64_t graineParDefaut(void);
+
+/**
+ * @brief Renvoie un nombre de 64 bits
+ */
+static inline uint64_t aleatoire64(Generateur *generateur){
+    if (!generateur->reste){
+        remplitAleatoire(generateur, generateur->tampon, ALEA_VOIES);
+        generateur->reste = ALEA_VOIES;
+    }
+    return generateur->tampon[--generateur->reste];
+}
+
+/**
+ * @brief Renvoie un entier de [0, n[, par multiplication plutôt que par modulo (biais d'au plus
+ * n / 2^64)
+ */
+static inline uint64_t entierAleatoire(Generateur *generateur, uint64_t n){
+    return (uint64_t) (((unsigned __int128) aleatoire64(generateur) * n) >> 64);
+}
+
+/**
+ * @brief Renvoie un réel de [0, 1[
+ */
+static inline double uniforme(Generateur *generateur){
+    return (aleatoire64(generateur) >> 11) * 0x1.0p-53;
+}
+
+///////////////////////
+// Fonctions tirages //
+///////////////////////
+
+/**
+ * @brief Initialise un tirage vide
+ */
+void initTirage(Tirage *tirage);
+
+/**
+ * @brief Prépare les tirages dans une forme, en O(R) pour le disque
+ *
+ * @param tirage Le tirage, dont la table est réutilisée
+ * @param forme FORME_CERCLE ou FORME_CARRE
+ * @param R Rayon de la forme (au moins 1)
+ * @param centre Centre de la forme
+ */
+void prepareTirage(Tirage *tirage, int forme, int R, Point centre);
+
+/**
+ * @brief Tire un point dans la forme, sans rejet
+ */
+Point tirePoint(Generateur *generateur, const Tirage *tirage);
+
+/**
+ * @brief Libère la table d'un tirage
+ */
+void libereTirage(Tirage *tirage);
+
+/**
+ * @brief Ajoute au nuage nbPoint points tirés dans une forme. Les points sont tirés par morceaux
+ * de ALEA_MORCEAU, le morceau k avec le flux k de la graine, en parallèle : les points ne
+ * dépendent que de la graine, pas du nombre de threads
+ *
+ * @param nuage Le nuage
+ * @param nbPoint Nombre de points
+ * @param forme FORME_CERCLE ou FORME_CARRE
+ * @param R Rayon de la forme
+ * @param centre Centre de la forme
+ * @param graine La graine
+ * @param nbThread Nombre de threads (0: un par processeur)
+ */
+void genereForme(NuagePoints *nuage, int nbPoint, int forme, int R, Point centre, uint64_t graine, int nbThread);
+
+#endif
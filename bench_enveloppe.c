@@ -0,0 +1,379 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "enveloppe.h"
+#include "statique.h"
+#include "filtre.h"
+#include "parallele.h"
+#include "aleatoire.h"
+
+#define SIZE_X 800
+#define SIZE_Y 800
+#define AMAS 8
+#define COUCHES_POINTS 4000 /* points des vérifications des couches, la cascade étant quadratique */
+#define COUCHES_GRILLE 12 /* côté de la grille pleine de doublons et de points alignés */
+
+/*
+ * Banc d'essai sans affichage : compare la boucle d'insertion point par point du mode
+ * "Terminal" et l'insertion par lots (pour chaque noyau de filtrage) au calcul statique, sur les
+ * mêmes points que commenceAleatoire.
+ * Vérifie aussi que les couches statiques sont celles de la cascade de traitementRecursif.
+ *
+ * Utilisation : bench_enveloppe [nbPoint] [forme (1: Cercle; 2: Carré; 3: Amas)] [graine] [threads]
+ */
+
+/**
+ * @brief Renvoie le temps écoulé en secondes depuis une origine arbitraire
+ */
+static double chrono(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Génère des amas de tailles très inégales : l'amas k reçoit environ un point sur 2^(k+1)
+ */
+static void genereAmas(NuagePoints *nuage, int nbPoint, Generateur *generateur){
+    Tirage tirages[AMAS];
+    for (int k = 0; k < AMAS; k++){
+        Point centre;
+        centre.x = 50 + entierAleatoire(generateur, SIZE_X - 100);
+        centre.y = 50 + entierAleatoire(generateur, SIZE_Y - 100);
+        initTirage(tirages + k);
+        prepareTirage(tirages + k, FORME_CERCLE, 10 + 4 * k, centre);
+    }
+
+    for (int i = 0; i < nbPoint; i++){
+        // Le nombre de bits à 1 de poids faible : k avec la probabilité 2^-(k+1)
+        uint64_t bits = aleatoire64(generateur);
+        int k = (~bits) ? __builtin_ctzll(~bits) : AMAS - 1;
+        if (k > AMAS - 1){
+            k = AMAS - 1;
+        }
+        ajoutePoint(nuage, tirePoint(generateur, tirages + k));
+    }
+
+    for (int k = 0; k < AMAS; k++){
+        libereTirage(tirages + k);
+    }
+}
+
+/**
+ * @brief Génère les points comme le mode aléatoire : 3 points initiaux puis un rayon croissant
+ *
+ * @param nuage Adresse du nuage vide
+ * @param nbPoint Nombre de points
+ * @param forme Forme de la génération aléatoire (1: Cercle; 2: Carré; 3: Amas)
+ * @param graine Graine du générateur
+ */
+static void generePoints(NuagePoints *nuage, int nbPoint, int forme, uint64_t graine){
+    Point centre; centre.x = SIZE_X/2; centre.y = SIZE_Y/2;
+    double rayonplus = 2;
+
+    Generateur generateur;
+    initGenerateur(&generateur, graine, 0);
+
+    if (forme == 3){
+        genereAmas(nuage, nbPoint, &generateur);
+        return;
+    }
+
+    Tirage tirage;
+    initTirage(&tirage);
+    prepareTirage(&tirage, FORME_CERCLE, 5, centre);
+    for (int i = 0; i < 3 && i < nbPoint; i++){
+        ajoutePoint(nuage, tirePoint(&generateur, &tirage));
+    }
+
+    for (int i = 3; i < nbPoint; i++){
+        if (rayonplus <= ((SIZE_X/2) - 5)){
+            rayonplus += 1;
+            prepareTirage(&tirage, forme, rayonplus, centre);
+        }
+        ajoutePoint(nuage, tirePoint(&generateur, &tirage));
+    }
+    libereTirage(&tirage);
+}
+
+/**
+ * @brief Compare les ensembles de sommets de deux enveloppes (le départ du polygone peut différer)
+ *
+ * @return 1 si les enveloppes ont les mêmes sommets dans le même ordre, 0 sinon
+ */
+static int memeEnveloppe(ConvexHull *a, ConvexHull *b){
+    if (a->curlen != b->curlen){
+        return 0;
+    }
+
+    Point premier = a->anneau[a->pol].p;
+    int depart = b->pol;
+    do{
+        if (b->anneau[depart].p.x == premier.x && b->anneau[depart].p.y == premier.y){
+            break;
+        }
+        depart = b->anneau[depart].next;
+    } while (depart != b->pol);
+
+    int va = a->pol;
+    int vb = depart;
+    for (int i = 0; i < a->curlen; i++){
+        if (a->anneau[va].p.x != b->anneau[vb].p.x || a->anneau[va].p.y != b->anneau[vb].p.y){
+            return 0;
+        }
+        va = a->anneau[va].next;
+        vb = b->anneau[vb].next;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Mesure la boucle d'insertion point par point
+ *
+ * @return La durée en secondes
+ */
+static double mesureIncrementale(Moteur *moteur, int nbPoint){
+    double debut = chrono();
+
+    for (int i = 0; i < nbPoint; i++){
+        insereMoteur(moteur, i);
+    }
+
+    return chrono() - debut;
+}
+
+/**
+ * @brief Mesure l'insertion par lots avec le noyau demandé
+ *
+ * @param nuage Le nuage
+ * @param noyau Le noyau de filtrage
+ * @param statique Le moteur statique de référence
+ */
+static void mesureLot(const NuagePoints *nuage, int noyau, Moteur *statique){
+    if (choisitNoyau(noyau) != noyau){
+        return;
+    }
+
+    Moteur *lot = creeMoteur(MOTEUR_ENVELOPPE, nuage);
+    if (!lot){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    reserveMoteur(lot, nuage->nbPoint);
+
+    double debut = chrono();
+    insereLotMoteur(lot, 0, nuage->nbPoint);
+    double tLot = chrono() - debut;
+
+    char nom[32];
+    snprintf(nom, sizeof nom, "par lots (%s)", nomNoyau());
+    printf("%-27s: %.3f s, %.1f ns/point, enveloppe %s\n", nom, tLot,
+           tLot * 1e9 / nuage->nbPoint,
+           memeEnveloppe(enveloppesMoteur(lot), enveloppesMoteur(statique)) ? "identique" : "DIFFERENTE");
+
+    detruitMoteur(lot);
+}
+
+/**
+ * @brief Mesure un calcul statique séquentiel
+ *
+ * @param nuage Le nuage
+ * @param options Options du moteur
+ * @param nom Nom affiché
+ * @param statique Le moteur statique de référence
+ */
+static void mesureStatique(const NuagePoints *nuage, int options, const char *nom, Moteur *statique){
+    Moteur *moteur = creeMoteur(options, nuage);
+    if (!moteur){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    moteur->largeurGrille = SIZE_X;
+
+    double debut = chrono();
+    construitMoteur(moteur);
+    double duree = chrono() - debut;
+
+    printf("%-27s: %.3f s, %.1f ns/point, enveloppe %s\n", nom, duree, duree * 1e9 / nuage->nbPoint,
+           memeEnveloppe(enveloppesMoteur(moteur), enveloppesMoteur(statique)) ? "identique" : "DIFFERENTE");
+
+    detruitMoteur(moteur);
+}
+
+/**
+ * @brief Mesure le calcul statique parallèle pour 1, 2, 4... threads jusqu'au nombre de processeurs
+ *
+ * @param nuage Le nuage
+ * @param options Options du moteur (avec ou sans MOTEUR_PREFILTRE, MOTEUR_QUICKHULL)
+ * @param statique Le moteur statique de référence
+ * @param coeurs Nombre maximal de threads
+ */
+static void mesureParallele(const NuagePoints *nuage, int options, Moteur *statique, int coeurs){
+    for (int nbThread = 1; ; nbThread *= 2){
+        if (nbThread > coeurs){
+            nbThread = coeurs;
+        }
+
+        Moteur *parallele = creeMoteur(options, nuage);
+        if (!parallele){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        parallele->nbThread = nbThread;
+
+        double debut = chrono();
+        construitMoteur(parallele);
+        double tParallele = chrono() - debut;
+
+        char nom[32];
+        snprintf(nom, sizeof nom, "%s x%d%s", (options & MOTEUR_QUICKHULL) ? "quickhull" : "parallele", nbThread,
+                 (options & MOTEUR_PREFILTRE) ? " + prefiltre" : "");
+        printf("%-27s: %.3f s, %.1f ns/point, enveloppe %s\n", nom, tParallele, tParallele * 1e9 / nuage->nbPoint,
+               memeEnveloppe(enveloppesMoteur(parallele), enveloppesMoteur(statique)) ? "identique" : "DIFFERENTE");
+
+        detruitMoteur(parallele);
+
+        if (nbThread == coeurs){
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Compare couche par couche les couches statiques à celles de la cascade de
+ * traitementRecursif, qui doivent être exactement les mêmes, sur un disque ou sur une petite
+ * grille pleine de doublons et de points alignés
+ *
+ * @param grille 0 pour le disque, 1 pour la grille
+ * @param graine Graine du générateur
+ */
+static void mesureCouches(int grille, uint64_t graine){
+    Point centre; centre.x = SIZE_X/2; centre.y = SIZE_Y/2;
+
+    Generateur generateur;
+    initGenerateur(&generateur, graine, 1 + grille);
+    Tirage tirage;
+    initTirage(&tirage);
+    prepareTirage(&tirage, FORME_CERCLE, (SIZE_X/2) - 5, centre);
+
+    NuagePoints nuage;
+    initNuage(&nuage, COUCHES_POINTS);
+    for (int i = 0; i < COUCHES_POINTS; i++){
+        Point P;
+        if (grille){
+            P.x = centre.x + 10 * (double) entierAleatoire(&generateur, COUCHES_GRILLE);
+            P.y = centre.y + 10 * (double) entierAleatoire(&generateur, COUCHES_GRILLE);
+        }
+        else{
+            P = tirePoint(&generateur, &tirage);
+        }
+        ajoutePoint(&nuage, P);
+    }
+    libereTirage(&tirage);
+
+    Moteur *cascade = creeMoteur(MOTEUR_COUCHES, &nuage);
+    Moteur *statique = creeMoteur(MOTEUR_COUCHES, &nuage);
+    if (!cascade || !statique){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    reserveMoteur(cascade, nuage.nbPoint);
+
+    double tCascade = mesureIncrementale(cascade, nuage.nbPoint);
+    double debut = chrono();
+    construitMoteur(statique);
+    double tStatique = chrono() - debut;
+
+    // Les couches sont comparées dans l'ordre, de l'extérieure à l'intérieure
+    int nbCouche = 0;
+    int identiques = 1;
+    ConvexHull *a = enveloppesMoteur(cascade);
+    ConvexHull *b = enveloppesMoteur(statique);
+    while (a && b){
+        identiques = identiques && memeEnveloppe(a, b);
+        nbCouche++;
+        a = a->next;
+        b = b->next;
+    }
+    identiques = identiques && !a && !b;
+
+    printf("%-27s: cascade %.3f s, statique %.3f s, %d couches %s\n", grille ? "couches (grille)" : "couches (disque)",
+           tCascade, tStatique, nbCouche, identiques ? "identiques" : "DIFFERENTES");
+
+    detruitMoteur(cascade);
+    detruitMoteur(statique);
+    libereNuage(&nuage);
+}
+
+int main(int argc, char *argv[]){
+    int nbPoint = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int forme = (argc > 2) ? atoi(argv[2]) : 1;
+    uint64_t graine = (argc > 3) ? strtoull(argv[3], NULL, 0) : 1;
+    int coeurs = (argc > 4) ? atoi(argv[4]) : nbCoeurs();
+
+    NuagePoints nuage;
+    initNuage(&nuage, nbPoint);
+    generePoints(&nuage, nbPoint, forme, graine);
+    int n = nuage.nbPoint;
+
+    Moteur *lineaire = creeMoteur(MOTEUR_ENVELOPPE | MOTEUR_LINEAIRE, &nuage);
+    Moteur *indexe = creeMoteur(MOTEUR_ENVELOPPE, &nuage);
+    Moteur *statique = creeMoteur(MOTEUR_ENVELOPPE, &nuage);
+    Moteur *prefiltre = creeMoteur(MOTEUR_ENVELOPPE | MOTEUR_PREFILTRE, &nuage);
+    if (!lineaire || !indexe || !statique || !prefiltre){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    reserveMoteur(lineaire, n);
+    reserveMoteur(indexe, n);
+
+    double tLineaire = mesureIncrementale(lineaire, n);
+    double tIndexe = mesureIncrementale(indexe, n);
+
+    double debut = chrono();
+    construitMoteur(statique);
+    double tStatique = chrono() - debut;
+
+    debut = chrono();
+    construitMoteur(prefiltre);
+    double tPrefiltre = chrono() - debut;
+
+    printf("%d points, forme %d, %d sommets\n", n, forme, enveloppesMoteur(statique)->curlen);
+    printf("point par point (lineaire) : %.3f s, %.1f ns/point\n", tLineaire, tLineaire * 1e9 / n);
+    printf("point par point (indexe)   : %.3f s, %.1f ns/point\n", tIndexe, tIndexe * 1e9 / n);
+    printf("statique                   : %.3f s, %.1f ns/point\n", tStatique, tStatique * 1e9 / n);
+    printf("statique + prefiltre       : %.3f s, %.1f ns/point, %d points ecartes (%.1f %%), enveloppe %s\n",
+           tPrefiltre, tPrefiltre * 1e9 / n, prefiltre->nbPrefiltre, 100.0 * prefiltre->nbPrefiltre / n,
+           memeEnveloppe(enveloppesMoteur(prefiltre), enveloppesMoteur(statique)) ? "identique" : "DIFFERENTE");
+    printf("acceleration prefiltre / statique : x%.2f\n", tStatique / tPrefiltre);
+    printf("acceleration statique / lineaire : x%.2f\n", tLineaire / tStatique);
+    printf("acceleration statique / indexe   : x%.2f\n", tIndexe / tStatique);
+    printf("enveloppes identiques : %s\n",
+           (memeEnveloppe(enveloppesMoteur(lineaire), enveloppesMoteur(statique))
+            && memeEnveloppe(enveloppesMoteur(indexe), enveloppesMoteur(statique))) ? "oui" : "non");
+
+    mesureStatique(&nuage, MOTEUR_ENVELOPPE | MOTEUR_CHAN, "chan", statique);
+    mesureStatique(&nuage, MOTEUR_ENVELOPPE | MOTEUR_CHAN | MOTEUR_PREFILTRE, "chan + prefiltre", statique);
+    mesureStatique(&nuage, MOTEUR_ENVELOPPE | MOTEUR_GRILLE, "grille", statique);
+    mesureParallele(&nuage, MOTEUR_ENVELOPPE, statique, coeurs);
+    mesureParallele(&nuage, MOTEUR_ENVELOPPE | MOTEUR_PREFILTRE, statique, coeurs);
+    mesureParallele(&nuage, MOTEUR_ENVELOPPE | MOTEUR_QUICKHULL, statique, coeurs);
+    mesureParallele(&nuage, MOTEUR_ENVELOPPE | MOTEUR_QUICKHULL | MOTEUR_PREFILTRE, statique, coeurs);
+
+    for (int noyau = NOYAU_SCALAIRE; noyau <= NOYAU_AVX2; noyau++){
+        mesureLot(&nuage, noyau, statique);
+    }
+
+    mesureCouches(0, graine);
+    mesureCouches(1, graine);
+
+    detruitMoteur(lineaire);
+    detruitMoteur(indexe);
+    detruitMoteur(statique);
+    detruitMoteur(prefiltre);
+    libereNuage(&nuage);
+
+    return 0;
+}
@@ -0,0 +1,301 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#include "enveloppe.h"
+#include "statique.h"
+#include "filtre.h"
+#include "aleatoire.h"
+
+#define SIZE_X 800
+#define SIZE_Y 800
+#define AMAS 8
+
+/*
+ * Suite de mesures des moteurs d'enveloppe et de couches sur plusieurs distributions, écrite
+ * en JSON sur la sortie standard. Chaque mesure est faite dans un processus fils, dont le pic
+ * de mémoire (points compris) est relevé par wait4. Compilée avec -DCOMPTEURS ou -DLATENCES, elle
+ * écrit aussi les compteurs ou les latences de chaque mesure sur la sortie d'erreur.
+ *
+ * Utilisation : bench_suite [nbPoint] [nbPoint des couches] [graine] [filtre]
+ * Le filtre garde les mesures dont la distribution ou le moteur contient le texte donné.
+ */
+
+/* Façons de donner les points au moteur */
+#define MODE_INCREMENTAL 0 /* insereMoteur point par point */
+#define MODE_LOTS        1 /* insereLotMoteur */
+#define MODE_STATIQUE    2 /* construitMoteur */
+
+/**
+ * @brief Un moteur mesuré
+ *
+ */
+typedef struct{
+    const char *nom;
+    int options; /* options de creeMoteur */
+    int mode; /* MODE_* */
+    int nbThread; /* threads de construitMoteur */
+    int couches; /* 1 si le moteur calcule les couches (mesuré sur moins de points) */
+} MoteurMesure;
+
+static const MoteurMesure moteurs[] = {
+    {"en_ligne", MOTEUR_ENVELOPPE, MODE_INCREMENTAL, 1, 0},
+    {"lots", MOTEUR_ENVELOPPE, MODE_LOTS, 1, 0},
+    {"statique", MOTEUR_ENVELOPPE, MODE_STATIQUE, 1, 0},
+    {"prefiltre", MOTEUR_ENVELOPPE | MOTEUR_PREFILTRE, MODE_STATIQUE, 1, 0},
+    {"parallele", MOTEUR_ENVELOPPE | MOTEUR_PREFILTRE, MODE_STATIQUE, 0, 0},
+    {"quickhull", MOTEUR_ENVELOPPE | MOTEUR_QUICKHULL | MOTEUR_PREFILTRE, MODE_STATIQUE, 0, 0},
+    {"chan", MOTEUR_ENVELOPPE | MOTEUR_CHAN | MOTEUR_PREFILTRE, MODE_STATIQUE, 1, 0},
+    {"grille", MOTEUR_ENVELOPPE | MOTEUR_GRILLE, MODE_STATIQUE, 1, 0},
+    {"couches_en_ligne", MOTEUR_COUCHES, MODE_INCREMENTAL, 1, 1},
+    {"couches_statiques", MOTEUR_COUCHES, MODE_STATIQUE, 1, 1},
+};
+
+static const char *distributions[] = {
+    "disque", /* loi de getPoint, cercle de rayon fixe */
+    "carre", /* loi de getPoint, carré de rayon fixe */
+    "disque_croissant", /* rayon croissant comme commenceAleatoire */
+    "carre_croissant",
+    "amas", /* amas de tailles très inégales */
+    "cercle", /* tous les points sur un cercle : h = n */
+};
+
+/**
+ * @brief Résultat d'une mesure, renvoyé par le processus fils
+ *
+ */
+typedef struct{
+    double secondes; /* durée du calcul, sans la génération des points */
+    int sommets; /* sommets de l'enveloppe extérieure */
+    int couches; /* nombre d'enveloppes */
+} Resultat;
+
+/**
+ * @brief Renvoie le temps écoulé en secondes depuis une origine arbitraire
+ */
+static double chrono(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Génère les points d'une distribution
+ *
+ * @param nuage Adresse du nuage vide
+ * @param nbPoint Nombre de points
+ * @param distribution Indice dans distributions
+ * @param graine Graine du générateur
+ */
+static void generePoints(NuagePoints *nuage, int nbPoint, int distribution, uint64_t graine){
+    Point centre; centre.x = SIZE_X/2; centre.y = SIZE_Y/2;
+    int rayonMax = (SIZE_X/2) - 5;
+    double rayonplus = 2;
+
+    Generateur generateur;
+    initGenerateur(&generateur, graine, 0);
+    Tirage tirage;
+    initTirage(&tirage);
+
+    switch (distribution){
+        case 0:
+        case 1:
+            genereForme(nuage, nbPoint, distribution + 1, rayonMax, centre, graine, 0);
+            break;
+
+        case 2:
+        case 3:
+            prepareTirage(&tirage, FORME_CERCLE, 5, centre);
+            for (int i = 0; i < 3 && i < nbPoint; i++){
+                ajoutePoint(nuage, tirePoint(&generateur, &tirage));
+            }
+            for (int i = 3; i < nbPoint; i++){
+                if (rayonplus <= rayonMax){
+                    rayonplus += 1;
+                    prepareTirage(&tirage, distribution - 1, rayonplus, centre);
+                }
+                ajoutePoint(nuage, tirePoint(&generateur, &tirage));
+            }
+            break;
+
+        case 4:{
+            Tirage amas[AMAS];
+            for (int k = 0; k < AMAS; k++){
+                Point centreAmas;
+                centreAmas.x = 50 + entierAleatoire(&generateur, SIZE_X - 100);
+                centreAmas.y = 50 + entierAleatoire(&generateur, SIZE_Y - 100);
+                initTirage(amas + k);
+                prepareTirage(amas + k, FORME_CERCLE, 10 + 4 * k, centreAmas);
+            }
+            for (int i = 0; i < nbPoint; i++){
+                // Le nombre de bits à 1 de poids faible : k avec la probabilité 2^-(k+1)
+                uint64_t bits = aleatoire64(&generateur);
+                int k = (~bits) ? __builtin_ctzll(~bits) : AMAS - 1;
+                if (k > AMAS - 1){
+                    k = AMAS - 1;
+                }
+                ajoutePoint(nuage, tirePoint(&generateur, amas + k));
+            }
+            for (int k = 0; k < AMAS; k++){
+                libereTirage(amas + k);
+            }
+            break;
+        }
+
+        default:
+            for (int i = 0; i < nbPoint; i++){
+                double angle = 2 * M_PI * uniforme(&generateur);
+                Point P;
+                P.x = centre.x + rayonMax * cos(angle);
+                P.y = centre.y + rayonMax * sin(angle);
+                ajoutePoint(nuage, P);
+            }
+    }
+    libereTirage(&tirage);
+}
+
+/**
+ * @brief Génère les points et mesure un moteur (dans le processus fils)
+ */
+static Resultat mesure(const MoteurMesure *moteurMesure, int distribution, int nbPoint, unsigned int graine){
+    Resultat resultat;
+    NuagePoints nuage;
+
+    initNuage(&nuage, nbPoint);
+    generePoints(&nuage, nbPoint, distribution, graine);
+
+    Moteur *moteur = creeMoteur(moteurMesure->options, &nuage);
+    if (!moteur){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    moteur->nbThread = moteurMesure->nbThread;
+    moteur->largeurGrille = SIZE_X;
+    if (moteurMesure->mode != MODE_STATIQUE){
+        reserveMoteur(moteur, nbPoint);
+    }
+
+    remetCompteurs();
+    remetLatences();
+
+    double debut = chrono();
+    if (moteurMesure->mode == MODE_INCREMENTAL){
+        for (int i = 0; i < nbPoint; i++){
+            insereMoteur(moteur, i);
+        }
+    }
+    else if (moteurMesure->mode == MODE_LOTS){
+        insereLotMoteur(moteur, 0, nbPoint);
+    }
+    else{
+        construitMoteur(moteur);
+    }
+    resultat.secondes = chrono() - debut;
+
+    resultat.sommets = enveloppesMoteur(moteur) ? enveloppesMoteur(moteur)->curlen : 0;
+    resultat.couches = 0;
+    for (ConvexHull *parcours = enveloppesMoteur(moteur); parcours; parcours = parcours->next){
+        resultat.couches += 1;
+    }
+
+#if defined(COMPTEURS) || defined(LATENCES)
+    fprintf(stderr, "%s / %s\n", distributions[distribution], moteurMesure->nom);
+    afficheCompteurs(stderr, enveloppesMoteur(moteur));
+    afficheLatences(stderr);
+#endif
+
+    detruitMoteur(moteur);
+    libereNuage(&nuage);
+
+    return resultat;
+}
+
+/**
+ * @brief Fait une mesure dans un processus fils et écrit son résultat en JSON
+ *
+ * @return 1 si la mesure a réussi
+ */
+static int mesureFils(const MoteurMesure *moteurMesure, int distribution, int nbPoint, unsigned int graine,
+                      int premier){
+    int tube[2];
+    if (pipe(tube) < 0){
+        return 0;
+    }
+
+    fflush(stdout);
+    pid_t fils = fork();
+    if (fils < 0){
+        close(tube[0]);
+        close(tube[1]);
+        return 0;
+    }
+
+    if (fils == 0){
+        close(tube[0]);
+        Resultat resultat = mesure(moteurMesure, distribution, nbPoint, graine);
+        int ok = write(tube[1], &resultat, sizeof resultat) == (ssize_t) sizeof resultat;
+        _exit(ok ? 0 : 1);
+    }
+
+    close(tube[1]);
+    Resultat resultat;
+    int lu = read(tube[0], &resultat, sizeof resultat) == (ssize_t) sizeof resultat;
+    close(tube[0]);
+
+    int etat;
+    struct rusage usage;
+    if (wait4(fils, &etat, 0, &usage) < 0 || !lu || !WIFEXITED(etat) || WEXITSTATUS(etat) != 0){
+        fprintf(stderr, "Echec de la mesure %s / %s\n", distributions[distribution], moteurMesure->nom);
+        return 0;
+    }
+
+    printf("%s\n    {\"distribution\": \"%s\", \"moteur\": \"%s\", \"n\": %d, \"secondes\": %.6f, "
+           "\"ns_par_point\": %.2f, \"memoire_max_ko\": %ld, \"sommets\": %d, \"couches\": %d}",
+           premier ? "" : ",", distributions[distribution], moteurMesure->nom, nbPoint, resultat.secondes,
+           nbPoint ? resultat.secondes * 1e9 / nbPoint : 0.0, usage.ru_maxrss, resultat.sommets,
+           resultat.couches);
+
+    return 1;
+}
+
+int main(int argc, char *argv[]){
+    int nbPoint = (argc > 1) ? atoi(argv[1]) : 1000000;
+    int nbPointCouches = (argc > 2) ? atoi(argv[2]) : 50000;
+    unsigned int graine = (argc > 3) ? (unsigned int) atoi(argv[3]) : 1;
+    const char *filtre = (argc > 4) ? argv[4] : NULL;
+
+    int nbDistribution = sizeof distributions / sizeof distributions[0];
+    int nbMoteur = sizeof moteurs / sizeof moteurs[0];
+    int premier = 1;
+    int echecs = 0;
+
+    printf("{\n  \"nbPoint\": %d,\n  \"nbPointCouches\": %d,\n  \"graine\": %u,\n  \"resultats\": [",
+           nbPoint, nbPointCouches, graine);
+
+    for (int d = 0; d < nbDistribution; d++){
+        for (int m = 0; m < nbMoteur; m++){
+            if (filtre && !strstr(distributions[d], filtre) && !strstr(moteurs[m].nom, filtre)){
+                continue;
+            }
+
+            int n = moteurs[m].couches ? nbPointCouches : nbPoint;
+            if (mesureFils(moteurs + m, d, n, graine, premier)){
+                premier = 0;
+            }
+            else{
+                echecs += 1;
+            }
+        }
+    }
+
+    printf("\n  ]\n}\n");
+
+    return echecs ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "compteurs.h"
+#include "enveloppe.h"
+
+#define COUCHES_AFFICHEES 8 /* couches dont la taille est donnée une à une */
+
+__thread Compteurs compteurs;
+
+void remetCompteurs(void){
+    memset(&compteurs, 0, sizeof compteurs);
+}
+
+void ajouteCompteurs(const Compteurs *autres){
+    compteurs.insertions += autres->insertions;
+    compteurs.orientations += autres->orientations;
+    compteurs.exactes += autres->exactes;
+    compteurs.evictionsAvant += autres->evictionsAvant;
+    compteurs.evictionsArriere += autres->evictionsArriere;
+    compteurs.reinsertions += autres->reinsertions;
+    if (autres->profondeurMax > compteurs.profondeurMax){
+        compteurs.profondeurMax = autres->profondeurMax;
+    }
+    for (int p = 0; p < COMPTEURS_PROFONDEUR; p++){
+        compteurs.profondeurs[p] += autres->profondeurs[p];
+    }
+}
+
+#ifdef COMPTEURS
+/**
+ * @brief Renvoie a / b, 0 si b est nul
+ */
+static double moyenne(unsigned long long a, unsigned long long b){
+    return b ? (double) a / b : 0;
+}
+#endif
+
+void afficheCompteurs(FILE *fichier, const struct s_convex *premiere){
+#ifdef COMPTEURS
+    const Compteurs *c = &compteurs;
+
+    fprintf(fichier, "compteurs : %llu insertions\n", c->insertions);
+    fprintf(fichier, "  orientations : %llu (%.2f par insertion), dont %llu exactes\n", c->orientations,
+            moyenne(c->orientations, c->insertions), c->exactes);
+    fprintf(fichier, "  vertex supprimes : %llu avant, %llu arriere (%.3f par insertion)\n", c->evictionsAvant,
+            c->evictionsArriere, moyenne(c->evictionsAvant + c->evictionsArriere, c->insertions));
+    fprintf(fichier, "  traitementRecursif : %llu appels (%.3f par insertion), profondeur maximale %d\n",
+            c->reinsertions, moyenne(c->reinsertions, c->insertions), c->profondeurMax);
+
+    fprintf(fichier, "  insertions par profondeur :");
+    for (int p = 0; p < COMPTEURS_PROFONDEUR; p++){
+        if (c->profondeurs[p]){
+            fprintf(fichier, " %d%s: %llu", p, (p == COMPTEURS_PROFONDEUR - 1) ? "+" : "", c->profondeurs[p]);
+        }
+    }
+    fprintf(fichier, "\n");
+
+    int nbCouche = 0;
+    long nbPoint = 0;
+    int plusGrande = 0;
+    for (const ConvexHull *parcours = premiere; parcours; parcours = parcours->next){
+        nbCouche += 1;
+        nbPoint += parcours->curlen;
+        if (parcours->curlen > plusGrande){
+            plusGrande = parcours->curlen;
+        }
+    }
+
+    fprintf(fichier, "  couches : %d, %ld points (%.1f par couche, au plus %d) :", nbCouche, nbPoint,
+            moyenne(nbPoint, nbCouche), plusGrande);
+    int i = 0;
+    for (const ConvexHull *parcours = premiere; parcours && i < COUCHES_AFFICHEES; parcours = parcours->next, i++){
+        fprintf(fichier, " %d", parcours->curlen);
+    }
+    fprintf(fichier, "%s\n", (nbCouche > COUCHES_AFFICHEES) ? " ..." : "");
+#else
+    (void) fichier;
+    (void) premiere;
+#endif
+}
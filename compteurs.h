@@ -0,0 +1,109 @@
+#ifndef COMPTEURS_H
+#define COMPTEURS_H
+
+#include <stdio.h>
+
+/*
+ * Compteurs des chemins chauds de l'insertion en ligne : tests d'orientation, vertex supprimés
+ * par le nettoyage, profondeur des cascades de traitementRecursif. Ils ne sont compilés qu'avec
+ * -DCOMPTEURS : sinon les fonctions de comptage sont vides et disparaissent à la compilation.
+ * Chaque thread a ses compteurs (sans synchronisation) ; le résumé est celui du thread appelant,
+ * qui fait toutes les insertions en ligne.
+ */
+
+#define COMPTEURS_PROFONDEUR 16 /* profondeurs de cascade distinguées (la dernière regroupe les plus grandes) */
+
+/**
+ * @brief Les compteurs d'un thread
+ *
+ */
+typedef struct{
+    unsigned long long insertions; /* appels de insereMoteur */
+    unsigned long long orientations; /* appels de orientationTriangle */
+    unsigned long long exactes; /* orientations refaites en arithmétique exacte */
+    unsigned long long evictionsAvant; /* vertex supprimés par nettoyageAvant2 */
+    unsigned long long evictionsArriere; /* vertex supprimés par nettoyageArriere2 */
+    unsigned long long reinsertions; /* appels de traitementRecursif (passage d'un point à une couche) */
+    int profondeur; /* imbrication courante de traitementRecursif */
+    int profondeurPoint; /* profondeur maximale atteinte par l'insertion en cours */
+    int profondeurMax; /* profondeur maximale depuis la remise à zéro */
+    unsigned long long profondeurs[COMPTEURS_PROFONDEUR]; /* insertions selon la profondeur atteinte */
+} Compteurs;
+
+extern __thread Compteurs compteurs;
+
+#ifdef COMPTEURS
+#define COMPTE(champ) (compteurs.champ += 1)
+#else
+#define COMPTE(champ) ((void) 0)
+#endif
+
+/**
+ * @brief Début d'une insertion par insereMoteur
+ */
+static inline void compteDebutInsertion(void){
+#ifdef COMPTEURS
+    compteurs.insertions += 1;
+    compteurs.profondeurPoint = 0;
+#endif
+}
+
+/**
+ * @brief Fin d'une insertion : sa profondeur de cascade est comptée
+ */
+static inline void compteFinInsertion(void){
+#ifdef COMPTEURS
+    int p = compteurs.profondeurPoint;
+    compteurs.profondeurs[(p < COMPTEURS_PROFONDEUR) ? p : COMPTEURS_PROFONDEUR - 1] += 1;
+    if (p > compteurs.profondeurMax){
+        compteurs.profondeurMax = p;
+    }
+#endif
+}
+
+/**
+ * @brief Entrée dans traitementRecursif
+ */
+static inline void compteEntreeCascade(void){
+#ifdef COMPTEURS
+    compteurs.reinsertions += 1;
+    compteurs.profondeur += 1;
+    if (compteurs.profondeur > compteurs.profondeurPoint){
+        compteurs.profondeurPoint = compteurs.profondeur;
+    }
+#endif
+}
+
+/**
+ * @brief Sortie de traitementRecursif
+ */
+static inline void compteSortieCascade(void){
+#ifdef COMPTEURS
+    compteurs.profondeur -= 1;
+#endif
+}
+
+struct s_convex;
+
+/**
+ * @brief Remet à zéro les compteurs du thread appelant
+ */
+void remetCompteurs(void);
+
+/**
+ * @brief Ajoute aux compteurs du thread appelant ceux d'un autre thread, recopiés avant sa fin
+ *
+ * @param autres Les compteurs de l'autre thread
+ */
+void ajouteCompteurs(const Compteurs *autres);
+
+/**
+ * @brief Écrit le résumé des compteurs du thread appelant et le nombre de points de chaque
+ * couche de la liste donnée. N'écrit rien si les compteurs ne sont pas compilés
+ *
+ * @param fichier Le fichier écrit
+ * @param premiere La première enveloppe (NULL: aucune)
+ */
+void afficheCompteurs(FILE *fichier, const struct s_convex *premiere);
+
+#endif
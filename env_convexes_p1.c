@@ -1,47 +1,19 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
-#include <math.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <MLV/MLV_all.h>
 
+#include "enveloppe.h"
+#include "statique.h"
+#include "rendu.h"
+#include "aleatoire.h"
+#include "raster.h"
+
 #define SIZE_X 800
 #define SIZE_Y 800
-
-typedef struct s_point{
-    double x;
-    double y;
-} Point;
-
-/**
- * @brief Liste chaînée simple pour gérer les points
- * 
- */
-typedef struct s_lst_point{
-    Point p;
-    struct s_lst_point *next;
-} CellulePoint, *ListePoint;
-
-/**
- * @brief Structure liste doublement chaînée circulaire d'un vertex contenant l'adresse d'un point 
- * et son vertex suivant et précédent
- * 
- */
-typedef struct _vrtx_{
-    Point *s; /* un point de l’ensemble */
-    struct _vrtx_ *prev; /* le vertex précédent */
-    struct _vrtx_ *next; /* le vertex suivant */
-} Vertex, *Polygon;
-
-/**
- * @brief Structure de l'enveloppe convexe contenant un Polygone (Une liste de vertex) et sa
- * taille actuelle et maximale
- * 
- */
-typedef struct{
-    Polygon pol; /* le polygône */
-    int curlen; /* la longueur courante */
-    int maxlen; /* la longueur maximale */
-} ConvexHull;
+#define MARGE 5 /* rayon des disques des sommets, plus un pixel */
 
 /////////////////////////////////
 // Fonctions fenêtre et dessin //
@@ -65,29 +37,43 @@ void drawPoint(Point p);
 Point getPointOnClic();
 
 /**
- * @brief Genere un point aléatoirement et qui fait partie de la fenêtre
+ * @brief Dessine le polygone donné en paramètre
  * 
- * @param forme 1: Génération aléatoire en forme de cercle 2: Génération aléatoire en forme de carré 
- * @param R Rayon du cercle/carré
- * @param centre Centre du cercle/carré
- * @return Point 
+ * @param enveloppe L'enveloppe dont le polygone est à dessiner
  */
-Point getPoint(int forme, int R, Point centre);
+void dessineConvexe(const ConvexHull *enveloppe);
 
 /**
- * @brief Dessine le polygone donné en paramètre
+ * @brief Dessine tous les points du nuage sur l'écran
+ * 
+ * @param nuage Le nuage des points
+ */
+void dessinePointsNuage(const NuagePoints *nuage);
+
+/**
+ * @brief Dessine les points du nuage en carte de densité : ils sont comptés par pixel (en
+ * parallèle), puis l'image de la carte est affichée en une fois
  * 
- * @param poly Le polygone à dessiner
- * @param curlen La taille actuelle du polygone (nombre de sommets)
+ * @param nuage Le nuage des points
  */
-void dessineConvexe(Polygon poly, int curlen);
+void dessineDensiteNuage(const NuagePoints *nuage);
 
 /**
- * @brief Dessine tous les points dans la liste chaînée listePoint sur l'écran
+ * @brief Dessine une image d'après un instantané : les points ajoutés depuis la précédente sont
+ * dessinés sur le fond, puis seule la zone modifiée est recopiée du fond et l'enveloppe y est
+ * redessinée
  * 
- * @param listePoint La liste chaînée de points
+ * @param instantane L'instantané du moteur
  */
-void dessinePointsListe(ListePoint listePoint);
+void dessineImage(const Instantane *instantane);
+
+/**
+ * @brief Publie un instantané du moteur et le dessine aussitôt, depuis le thread du calcul
+ * 
+ * @param moteur Le moteur de calcul
+ * @param nuage Le nuage des points
+ */
+void afficheMoteur(const Moteur *moteur, const NuagePoints *nuage);
 
 /**
  * @brief Ouvre le menu principal du programme
@@ -115,58 +101,38 @@ int mouseOnButton(int x, int y, int x_button, int y_button, int widthButton, int
 // Fonctions de calcul //
 /////////////////////////
 
-/**
- * @brief Renvoie l'orientation d'un triangle
- * 
- * @param Sommet A du triangle
- * @param Sommet B du triangle
- * @param Sommet C du triangle
- * @return 0 si l'orientation est indirecte, 1 sinon
- */
-int orientationTriangle(Point A, Point B, Point C);
-
-
-int appartientCercle(Point P, Point centre, int R);
-int appartientCarre(Point P, Point centre, int R);
-
 /**
  * @brief Genere l'enveloppe convexe initiale de 3 points
  * 
- * @param enveloppe L'adresse de l'enveloppe convexe vide
- * @param listePoint La liste des points vide
+ * @param moteur Le moteur de calcul vide
+ * @param nuage Le nuage des points vide
  * @param utilisateur Mode du programme (0: Aléatoire; 1: Clic-souris)
- * @param nbPoint Nombre de points si aléatoire
  * @param deroulement Mode d'affichage (0: Point par point; 1: Terminal)
  */
-void genereEnveloppe(ConvexHull *enveloppe, ListePoint *listePoint, int utilisateur, int nbPoint, int deroulement);
+void genereEnveloppe(Moteur *moteur, NuagePoints *nuage, int utilisateur, int deroulement);
 
 /**
- * @brief Calcule l'orientation et insère un point dans l'enveloppe à sa place
- * 
- * @param P L'adresse du point à vérifier dans la liste des points
- * @param poly L'adresse du polygone
- * @param enveloppe L'adresse de l'enveloppe convexe
- * @return 0 si pas d'insertion (orientation directe), 1 sinon
+ * @brief Travail du thread de calcul du mode aléatoire
+ *
  */
-int insertionPoint(Point *P, Polygon *poly, ConvexHull *enveloppe);
-
-/**
- * @brief Effectue le nettoyage avant de l'enveloppe après insertion, et supprime les vertex qu'il
- * faut supprimer
- * 
- * @param poly Adresse du polygone
- * @param enveloppe Adresse de l'enveloppe
- */
-void nettoyageAvant2(Polygon *poly, ConvexHull *enveloppe);
+typedef struct{
+    Moteur *moteur; /* le moteur de calcul */
+    NuagePoints *nuage; /* le nuage des points */
+    int nbPoint; /* nombre de points */
+    int choix; /* forme de la génération aléatoire (1: Cercle; 2: Carré) */
+    int deroulement; /* mode d'affichage (0: Point par point; 1: Terminal) */
+    Compteurs compteurs; /* compteurs du thread, recopiés à sa fin */
+    Latences *latences; /* mesures du thread, retirées à sa fin */
+} Calcul;
 
 /**
- * @brief Effectue le nettoyage après de l'enveloppe après insertion, et supprime les vertex qu'il
- * faut supprimer
+ * @brief Tire les points aléatoires ; en mode point par point, les insère un à un et publie un
+ * instantané du moteur à chaque image due
  * 
- * @param poly Adresse du polygone
- * @param enveloppe Adresse de l'enveloppe
+ * @param arg Le Calcul
+ * @return NULL
  */
-void nettoyageArriere2(Polygon *poly, ConvexHull *enveloppe);
+void *calculeAleatoire(void *arg);
 
 /////////////////////
 // Fonctions start //
@@ -175,44 +141,29 @@ void nettoyageArriere2(Polygon *poly, ConvexHull *enveloppe);
 /**
  * @brief Commence le programme (mode clic-souris)
  * 
- * @param enveloppe Adresse de l'enveloppe convexe
- * @param listePoint Adresse de la liste de points
+ * @param moteur Le moteur de calcul
+ * @param nuage Adresse du nuage des points
  */
-void commenceClic(ConvexHull *enveloppe, ListePoint *listePoint);
+void commenceClic(Moteur *moteur, NuagePoints *nuage);
 
 /**
  * @brief Commence le programme (mode aléatoire)
  * 
- * @param enveloppe Adresse de l'enveloppe convexe
- * @param listePoint Adresse de la liste de points
+ * @param moteur Le moteur de calcul
+ * @param nuage Adresse du nuage des points
  * @param nbPoint Nombre de points
  * @param choix Forme de la génération aléatoire (1: Cercle; 2: Carré)
  * @param deroulement Mode d'affichage (0: Point par point; 1: Terminal)
  */
-void commenceAleatoire(ConvexHull *enveloppe, ListePoint *listePoint, int nbPoint , int choix, int deroulement);
-
-/////////////////////////
-// Fonctions enveloppe //
-/////////////////////////
-
-void printConvex(ConvexHull enveloppe);
-void printConvexAdresse(Polygon pol);
-
-////////////////////////////
-// Fonctions liste points //
-////////////////////////////
-
-ListePoint alloueCellule(Point p);
-ListePoint insereTete(ListePoint *liste, Point p);
-void printListePoint(ListePoint liste);
+void commenceAleatoire(Moteur *moteur, NuagePoints *nuage, int nbPoint , int choix, int deroulement);
 
 /**
- * @brief Libère la liste chaînée de points ainsi que l'enveloppe convexe
+ * @brief Libère le nuage des points ainsi que le moteur et son enveloppe convexe
  * 
- * @param listePoint Adresse de la liste chaînée de points
- * @param enveloppe Adresse de l'enveloppe
+ * @param nuage Adresse du nuage des points
+ * @param moteur Le moteur de calcul
  */
-void freeListes(ListePoint *listePoint, ConvexHull *enveloppe);
+void freeListes(NuagePoints *nuage, Moteur *moteur);
 
 /**
  * @brief Fonction d'arrêt appelée lors d'un clic sur le bouton fermer
@@ -220,12 +171,21 @@ void freeListes(ListePoint *listePoint, ConvexHull *enveloppe);
  * @param data Variable arret à modifier par adresse
  */
 void exit_function(void* data){
-    int* arret = (int*) data;
-    *arret = 1;
+    atomic_int* arret = (atomic_int*) data;
+    atomic_store(arret, 1);
 }
 
-// Variable pour vérifier l'arrêt du programme
-int arret = 0;
+// Variable pour vérifier l'arrêt du programme, lue aussi par le thread de calcul du mode aléatoire
+atomic_int arret = 0;
+
+// Fond blanc où sont dessinés les points (mode point par point), ce qui est à l'écran, et les
+// instantanés publiés par le calcul
+MLV_Image *fond = NULL;
+Affichage affichage;
+Echange echange;
+
+// Générateur des points du mode aléatoire (un seul thread tire à la fois)
+Generateur generateur;
 
 int main(void){
     int utilisateur = 0;
@@ -233,7 +193,9 @@ int main(void){
     int deroulement = 0;
     int nbPoint = 0;
     int lu =0 ;
-    srand(time(NULL));
+    uint64_t graine = graineParDefaut();
+    initGenerateur(&generateur, graine, 0);
+    activeTrace(getenv("ENVELOPPE_TRACE") != NULL);
     
     menu(&utilisateur, &forme, &deroulement);
     if (!utilisateur){
@@ -243,6 +205,7 @@ int main(void){
         lu = scanf("%d", &nbPoint);
         while ( (c = getchar()) != '\n' && c != EOF);
     }while (lu == 0);
+    printf("Graine : %" PRIu64 " (ENVELOPPE_GRAINE=%" PRIu64 " rejoue ce tirage)\n", graine, graine);
     }
     MLV_execute_at_exit(exit_function, &arret);
     
@@ -250,20 +213,33 @@ int main(void){
         creerFenetre();
         effaceEcran(); 
         MLV_actualise_window(); 
+
+        fond = MLV_create_image(SIZE_X, SIZE_Y);
+        MLV_draw_filled_rectangle_on_image(0, 0, SIZE_X, SIZE_Y, MLV_COLOR_WHITE, fond);
     }
-    ConvexHull enveloppe;
-    enveloppe.pol = NULL;
+    initAffichage(&affichage, SIZE_X, SIZE_Y, MARGE);
+    initEchange(&echange);
+    // Le nombre de points est connu en mode aléatoire : le nuage est alloué en une fois
+    NuagePoints nuage;
+    initNuage(&nuage, utilisateur ? 0 : nbPoint);
 
-    ListePoint listePoint = NULL;
+    Moteur *moteur = creeMoteur(MOTEUR_ENVELOPPE | MOTEUR_PREFILTRE | MOTEUR_GRILLE, &nuage);
+    if (!moteur){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    reserveMoteur(moteur, nbPoint + 3);
+    moteur->nbThread = 0; // calcul statique du mode "Terminal" sur tous les processeurs
+    moteur->largeurGrille = SIZE_X; // les points tirés ou cliqués sont des pixels de la fenêtre
 
-    genereEnveloppe(&enveloppe, &listePoint, utilisateur, nbPoint, deroulement);
+    genereEnveloppe(moteur, &nuage, utilisateur, deroulement);
 
     if (utilisateur){
-        commenceClic(&enveloppe, &listePoint);
+        commenceClic(moteur, &nuage);
     }
     else{        
         // Cercle = 1; Carré = 2
-        commenceAleatoire(&enveloppe, &listePoint, nbPoint, forme, deroulement);
+        commenceAleatoire(moteur, &nuage, nbPoint, forme, deroulement);
     }
 
     if (!utilisateur){
@@ -272,7 +248,16 @@ int main(void){
         }
     }
 
-    freeListes(&listePoint, &enveloppe);
+    afficheCompteurs(stdout, enveloppesMoteur(moteur));
+    afficheLatences(stdout);
+    ecritTraceLatences(getenv("ENVELOPPE_TRACE"));
+
+    freeListes(&nuage, moteur);
+    libereAffichage(&affichage);
+    libereEchange(&echange);
+    if (fond){
+        MLV_free_image(fond);
+    }
     MLV_free_window();
 
     return 0;
@@ -283,7 +268,6 @@ void creerFenetre(){
 }
 
 Point getPointOnClic(){
-    double PERTURB = 0.0001/RAND_MAX;
     Point P;
     int x = -10; int y = -10;
     
@@ -291,8 +275,9 @@ Point getPointOnClic(){
         MLV_wait_mouse_or_seconds(&x,&y, 1);
     }
     
-    P.x = x + (rand()%2 ? +1. : -1.)*PERTURB*rand();
-    P.y = y + (rand()%2 ? +1. : -1.)*PERTURB*rand();
+    // Le prédicat d'orientation est exact : les points alignés n'ont pas besoin d'être perturbés
+    P.x = x;
+    P.y = y;
 
     return P;
 }
@@ -304,128 +289,21 @@ void drawPoint(Point p){
     MLV_actualise_window();
 }
 
-int orientationTriangle(Point A, Point B, Point C){
-    return (B.x - A.x) * (C.y - A.y) - (C.x - A.x) * (B.y - A.y);
-}
-
-Polygon newCell(Point *P){
-    Polygon poly;
-    poly = (Polygon) malloc(sizeof(Vertex));
-    if (!poly){ 
-        fprintf(stderr,"Plus de memoire "); 
-        exit(-1);
-    }
-    poly->s = P;
-    poly->next = poly->prev = poly;
-
-    return poly;
-}
-
-void addBefore(Polygon poly, Polygon ins, Polygon *head){
-    
-    if (!poly)
-       { *head = ins; return ;}
-    ins->next = poly;
-    ins->prev = poly->prev;
-    poly->prev = ins ;
-    if (! ins->prev)
-    { *head = ins; }
-    else 
-    { 
-    ins->prev->next = ins ;
-    }
-
-} 
-
-void addAfter(Polygon after, Polygon ins, Polygon *head){
-    if (! after){ // empty list
-        *head = ins; 
-       return ;
-       }
-    ins->next = after->next;
-    if (after->next)  ins->next->prev = ins ;
-    ins->prev = after;
-    after->next = ins ;
-} 
-
-void printConvex(ConvexHull enveloppe){ 
-    if (enveloppe.pol != NULL){
-        Point *premierPoint = enveloppe.pol->s;
-        printf("x: %f, y: %f\n", (enveloppe.pol->s)->x, (enveloppe.pol->s)->y);
-        enveloppe.pol = enveloppe.pol->next;
-        
-        
-        for(; enveloppe.pol->s != premierPoint ; enveloppe.pol = enveloppe.pol->next){
-            printf("x: %f, y: %f\n", (enveloppe.pol->s)->x, (enveloppe.pol->s)->y);
-        }
-        
-        printf("\n");
-    }
-}
-
-void printConvexAdresse(Polygon pol){ 
-    if (pol != NULL){
-        Point *premierPoint = pol->s;
-        printf("x: %f, y: %f, ADRESSE: %p,  ADRESSE PREV: %p, ADRESSE NEXT: %p\n", (pol->s)->x, (pol->s)->y, pol, pol->prev, pol->next);
-        pol = pol->next;
-        
-        
-        for(; pol->s != premierPoint ; pol = pol->next){
-            printf("x: %f, y: %f, ADRESSE: %p,  ADRESSE PREV: %p, ADRESSE NEXT: %p\n", (pol->s)->x, (pol->s)->y, pol, pol->prev, pol->next);
-        }
-        
-        printf("\n");
-    }
-}
-
-
-int appartientCercle(Point P, Point centre, int R){
-    return ((int)((P.x - centre.x)*(P.x - centre.x)) + ((P.y - centre.y)*(P.y - centre.y)) <= (int)R*R);
-}
-
-int appartientCarre(Point P, Point centre, int R){
-    return ((int)fabs((P.x - centre.x)+(P.y - centre.y)) + (int)fabs((P.x - centre.x) - (P.y - centre.y)) <= (int)R*2);
-}
-
-Point getPoint(int forme, int R, Point centre){
-    Point P;
-    
-    // Cercle
-    if (forme == 1){
-        do{
-            P.x = centre.x - R + (rand() % (2*R));
-            P.y = centre.y - R + (rand() % (2*R));
-        } while(!appartientCercle(P, centre, R));
-    }
-    // Carré
-    else{
-        do{
-            P.x = centre.x - R + (rand() % (2*R));
-            P.y = centre.y - R + (rand() % (2*R));
-        } while(!appartientCarre(P, centre, R));
-    }
-    
-    return P;
-}
-
-
-void genereEnveloppe(ConvexHull *enveloppe, ListePoint *listePoint, int utilisateur, int nbPoint, int deroulement){
-    enveloppe->curlen = 0;
-    
+void genereEnveloppe(Moteur *moteur, NuagePoints *nuage, int utilisateur, int deroulement){
     Point P0, P1, P2;
     
     if (!utilisateur){
-        enveloppe->maxlen = nbPoint;
-
         Point centre; centre.x = SIZE_X/2; centre.y = SIZE_Y/2;
 
-        P0 = getPoint(1, 5, centre);
-        P1 = getPoint(1, 5, centre);
-        P2 = getPoint(1, 5, centre);
+        Tirage tirage;
+        initTirage(&tirage);
+        prepareTirage(&tirage, FORME_CERCLE, 5, centre);
+        P0 = tirePoint(&generateur, &tirage);
+        P1 = tirePoint(&generateur, &tirage);
+        P2 = tirePoint(&generateur, &tirage);
+        libereTirage(&tirage);
     }
     else{
-        enveloppe->maxlen = 0;
-
         P0 = getPointOnClic();
         drawPoint(P0);
         P1 = getPointOnClic();
@@ -434,81 +312,32 @@ void genereEnveloppe(ConvexHull *enveloppe, ListePoint *listePoint, int utilisat
         drawPoint(P2);
     }
     
-    if(orientationTriangle(P0,P1,P2) >= 0){
-        insereTete(listePoint, P2);
-        if (!listePoint) { return; }
-        insereTete(listePoint, P1);
-        if (!listePoint) { return; }
-        insereTete(listePoint, P0);
-        if (!listePoint) { return; }
-    }
-    else if(orientationTriangle(P0,P2,P1) >= 0){
-        insereTete(listePoint, P1);
-        if (!listePoint) { return; }
-        insereTete(listePoint, P2);
-        if (!listePoint) { return; }
-        insereTete(listePoint, P0);
-        if (!listePoint) { return; }
-    }
-
-    enveloppe->maxlen = 3;
-
-    ListePoint parcours = *listePoint;
-    for (; parcours ; parcours = parcours->next){
-        Polygon poly = newCell(&(parcours->p));
-        addBefore(enveloppe->pol, poly, &enveloppe->pol);
-    }
-
-    enveloppe->curlen = 3;
+    // Le moteur oriente lui-même le triangle initial
+    insereMoteur(moteur, ajoutePoint(nuage, P0));
+    insereMoteur(moteur, ajoutePoint(nuage, P1));
+    insereMoteur(moteur, ajoutePoint(nuage, P2));
 
     if (deroulement == 0 && !arret){
-        dessineConvexe(enveloppe->pol, enveloppe->curlen);
+        afficheMoteur(moteur, nuage);
     }
 }
 
-int insertionPoint(Point *P, Polygon *poly, ConvexHull *enveloppe){
-    Point *premierPoint = (*poly)->s;
-    Polygon copy = *poly;
-    int orientation;
-    
-    do{
-        Point P1 = *((copy)->s);
-        Point P2 = *((copy)->next->s);
-
-        orientation = orientationTriangle(*P, P1, P2);
-        
-        (copy) = (copy)->next;
-    } while ((copy)->s != premierPoint && orientation >= 0);
-
-
-    if (orientation < 0){
-        Polygon ins = newCell(P);
-        addBefore(copy, ins, &((copy)));
-        copy = copy->prev ;
-        enveloppe->curlen += 1;
-        nettoyageAvant2(&(copy), enveloppe);
-        nettoyageArriere2(&(copy), enveloppe);
-        enveloppe->pol = copy ;
-        return 1;
-    }
-
-
-    return 0;
-}
-
 void effaceEcran(){
     MLV_clear_window(MLV_COLOR_WHITE);
 }
 
-void dessineConvexe(Polygon poly, int curlen){
+void dessineConvexe(const ConvexHull *enveloppe){
+    uint64_t debut = debutLatence();
 
-    Point *premierPoint = poly->s;
+    const Vertex *anneau = enveloppe->anneau;
+    int curlen = enveloppe->curlen;
+    int poly = enveloppe->pol;
     int tab_x[curlen]; int tab_y[curlen];
     
     int i = 0;
     do{
-        Point P0 = (*poly->s);
-        Point P1 = (*poly->next->s);
+        Point P0 = anneau[poly].p;
+        Point P1 = anneau[anneau[poly].next].p;
 
         tab_x[i] = P0.x;
         tab_y[i] = P0.y;
@@ -517,13 +346,14 @@ void dessineConvexe(Polygon poly, int curlen){
         MLV_draw_filled_circle(P1.x, P1.y, 4, MLV_COLOR_RED);
         MLV_draw_line(P0.x, P0.y, P1.x, P1.y, MLV_rgba(255,0,0,80));
 
-        poly = poly->next;
+        poly = anneau[poly].next;
         i += 1;
-    } while (poly->s != premierPoint);
+    } while (poly != enveloppe->pol);
 
     
     MLV_draw_filled_polygon(tab_x, tab_y, curlen, MLV_rgba(255,0,0,64));
-    MLV_actualise_window();
+
+    finLatence(LATENCE_DESSIN, debut);
 }
 
 void dessinePoints(Point *tabPoint, int nbPoint){
@@ -534,160 +364,189 @@ void dessinePoints(Point *tabPoint, int nbPoint){
 
 }
 
-void dessinePointsListe(ListePoint listePoint){
+void dessinePointsNuage(const NuagePoints *nuage){
+    // Au-delà de DENSITE_SEUIL points, les disques se recouvrent : un appel par pixel au lieu
+    // d'un par point
+    if (nuage->nbPoint > DENSITE_SEUIL){
+        dessineDensiteNuage(nuage);
+        return;
+    }
 
-    for(; listePoint; listePoint = listePoint->next){
-        MLV_draw_filled_circle(listePoint->p.x, listePoint->p.y, 3, MLV_COLOR_BLACK);
+    for(int i = 0; i < nuage->nbPoint; i++){
+        MLV_draw_filled_circle(nuage->x[i], nuage->y[i], 3, MLV_COLOR_BLACK);
     }
 
 }
 
+void dessineDensiteNuage(const NuagePoints *nuage){
+    const Couleur blanc = {255, 255, 255};
+    const Couleur noir = {0, 0, 0};
+
+    Densite densite;
+    creeDensite(&densite, SIZE_X, SIZE_Y);
+    accumuleDensite(&densite, nuage, 1.0, 0.0, 0.0, 0);
+
+    // Seuls les pixels occupés sont posés sur l'image, affichée en une fois
+    MLV_Image *carte = MLV_create_image(SIZE_X, SIZE_Y);
+    MLV_draw_filled_rectangle_on_image(0, 0, SIZE_X, SIZE_Y, MLV_COLOR_WHITE, carte);
+    for (int y = 0; y < SIZE_Y; y++){
+        for (int x = 0; x < SIZE_X; x++){
+            if (densite.comptes[y * SIZE_X + x]){
+                Couleur c = couleurDensite(&densite, x, y, blanc, noir);
+                MLV_set_pixel_on_image(x, y, MLV_rgba(c.r, c.g, c.b, 255), carte);
+            }
+        }
+    }
+    MLV_draw_image(carte, 0, 0);
 
-void commenceClic(ConvexHull *enveloppe, ListePoint *listePoint){
-    
-    while (!arret){
-        Point P = getPointOnClic();
+    MLV_free_image(carte);
+    libereDensite(&densite);
+}
 
-        insereTete(listePoint, P);
+void dessineImage(const Instantane *instantane){
+    Zone zone;
 
-        // dessinePointsListe(*listePoint);
-        
-        if (listePoint && !arret){
-            insertionPoint(&((*listePoint)->p), &(enveloppe->pol), enveloppe);
-            
-            effaceEcran();
-            dessinePointsListe(*listePoint);
-            dessineConvexe(enveloppe->pol, enveloppe->curlen);
-        }
+    // Chaque point n'est dessiné qu'une fois, sur le fond
+    int premier = (affichage.nbPoint > instantane->premierPoint) ? affichage.nbPoint : instantane->premierPoint;
+    for (int i = premier; i < instantane->nbPoint; i++){
+        int j = i - instantane->premierPoint;
+        MLV_draw_filled_circle_on_image(instantane->x[j], instantane->y[j], 3, MLV_COLOR_BLACK, fond);
     }
-    
-}
 
-void nettoyageAvant2(Polygon *poly, ConvexHull *enveloppe){
-    Point P = *((*poly)->s );
-    Point P1 = *((*poly)->next->s );
-    Point P2 = *((*poly)->next->next->s );
-    
-    while(orientationTriangle(P,P1,P2) <= 0 ){
-        
-        Polygon adresseSupp = (*poly)->next;
-        
-        (*poly)->next = (*poly)->next->next;
-        (*poly)->next->prev = (*poly);
+    if (!zoneModifiee(&affichage, instantane, &zone)){
+        return;
+    }
 
-        free(adresseSupp);
-        
-        enveloppe->curlen -= 1 ;
-        
-        P1 = *((*poly)->next->s );
-        P2 = *((*poly)->next->next->s );
+    // L'enveloppe est transparente : elle n'est redessinée que sur un fond recopié, et la zone
+    // la contient dès qu'elle la coupe
+    MLV_draw_partial_image(fond, zone.x0, zone.y0, zone.x1 - zone.x0, zone.y1 - zone.y0, zone.x0, zone.y0);
+    const ConvexHull *enveloppe = premiereCouche(instantane);
+    if (enveloppe && intersecteZones(&zone, boiteCouche(&affichage, 0))){
+        dessineConvexe(enveloppe);
     }
 
+    MLV_actualise_window();
+}
+
+void afficheMoteur(const Moteur *moteur, const NuagePoints *nuage){
+    publieInstantane(&echange, moteur, nuage);
+    dessineImage(prendInstantane(&echange));
 }
 
-void nettoyageArriere2(Polygon *poly, ConvexHull *enveloppe){
 
-    Point P = *((*poly)->s );
-    Point P1 = *((*poly)->prev->prev->s );
-    Point P2 = *((*poly)->prev->s );
+void commenceClic(Moteur *moteur, NuagePoints *nuage){
     
-    while(orientationTriangle(P,P1,P2) <= 0 ){
-        
-        Polygon adresseSupp = (*poly)->prev;
+    while (!arret){
+        Point P = getPointOnClic();
 
-        (*poly)->prev = (*poly)->prev->prev;
-        (*poly)->prev->next = (*poly);
-        
-        free(adresseSupp);
+        int indice = ajoutePoint(nuage, P);
 
-        enveloppe->curlen -= 1 ;
-        
-        P1 = *((*poly)->prev->prev->s );
-        P2 = *((*poly)->prev->s );
+        if (!arret){
+            insereMoteur(moteur, indice);
+            afficheMoteur(moteur, nuage);
+        }
     }
+    
 }
 
-void commenceAleatoire(ConvexHull *enveloppe, ListePoint *listePoint, int nbPoint , int choix, int deroulement){
+void *calculeAleatoire(void *arg){
+    Calcul *calcul = (Calcul *) arg;
     Point centre; centre.x = SIZE_X/2; centre.y = SIZE_Y/2;
 
     double rayonplus = 2;
+    Tirage tirage;
+    initTirage(&tirage);
 
-    if (deroulement == 1){
-        printf("Calcul en cours...\n");
+    // Les insertions faites entre deux images sont publiées ensemble
+    Cadence cadence;
+    initCadence(&cadence, IMAGES_PAR_SECONDE);
+
+    if (calcul->deroulement == 0){
+        activeTrace(getenv("ENVELOPPE_TRACE") != NULL);
     }
-    
-    for(int i = 3 ; (i < nbPoint) && !arret; i++ ){
+
+    for(int i = 3 ; (i < calcul->nbPoint) && !arret; i++ ){
         if (rayonplus <= ((SIZE_X/2) - 5)){
             rayonplus += 1; 
         }
 
         Point P;
-        P = getPoint(choix, rayonplus, centre);
+        // La table du disque n'est refaite que quand le rayon change
+        if (tirage.rayon != (int) rayonplus){
+            prepareTirage(&tirage, calcul->choix, rayonplus, centre);
+        }
+        P = tirePoint(&generateur, &tirage);
         
-        // if(deroulement == 1){
-        //     printListePoint(*listePoint);
-        // }
-        insereTete(listePoint, P);
+        int indice = ajoutePoint(calcul->nuage, P);
         
-        if (deroulement == 0){
-            insertionPoint(&((*listePoint)->p), &(enveloppe->pol), enveloppe);
-            
-            effaceEcran();
-            
-            dessinePointsListe(*listePoint);
-            
-            dessineConvexe(enveloppe->pol, enveloppe->curlen);
-        }
-    }
+        if (calcul->deroulement == 0){
+            insereMoteur(calcul->moteur, indice);
 
-    if (deroulement == 1){
-        ListePoint parcours = (*listePoint);
-
-        for (; parcours->next; parcours = parcours->next){
-            insertionPoint(&(parcours->p), &(enveloppe->pol), enveloppe);
+            if (imageDue(&cadence)){
+                publieInstantane(&echange, calcul->moteur, calcul->nuage);
+            }
         }
+    }
 
-        creerFenetre();
-        effaceEcran();
-
-        printf("Calcul terminé\n");
+    if (calcul->deroulement == 0){
+        publieInstantane(&echange, calcul->moteur, calcul->nuage);
+        termineEchange(&echange);
 
-        dessinePointsListe(*listePoint);
-        dessineConvexe(enveloppe->pol, enveloppe->curlen);
+        // Les mesures du thread disparaissent avec lui
+        calcul->compteurs = compteurs;
+        calcul->latences = detacheLatences();
     }
 
+    libereTirage(&tirage);
+
+    return NULL;
 }
 
-ListePoint alloueCellule(Point p){
-    ListePoint tmp;
+void commenceAleatoire(Moteur *moteur, NuagePoints *nuage, int nbPoint , int choix, int deroulement){
+    Calcul calcul;
+    calcul.moteur = moteur;
+    calcul.nuage = nuage;
+    calcul.nbPoint = nbPoint;
+    calcul.choix = choix;
+    calcul.deroulement = deroulement;
 
-    tmp = (CellulePoint *) malloc(sizeof(CellulePoint));
+    if (deroulement == 0){
+        // Le calcul a son thread : celui-ci ne fait que dessiner le dernier instantané publié
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, calculeAleatoire, &calcul)){
+            fprintf(stderr,"Creation de thread impossible ");
+            exit(-1);
+        }
 
-    if (tmp != NULL){
-        tmp->p = p;
-        tmp->next = NULL;
-    }
+        const Instantane *instantane;
+        while ((instantane = attendInstantane(&echange))){
+            if (!arret){
+                dessineImage(instantane);
+            }
+        }
 
-    return tmp;
-}
+        pthread_join(thread, NULL);
+        ajouteCompteurs(&(calcul.compteurs));
+        rattacheLatences(calcul.latences, 2);
+    }
 
-ListePoint insereTete(ListePoint *liste, Point p){
-    ListePoint tmp;
+    if (deroulement == 1){
+        printf("Calcul en cours...\n");
+        calculeAleatoire(&calcul);
 
-    tmp = alloueCellule(p);
+        // Tous les points sont connus : calcul statique au lieu d'une insertion par point
+        construitMoteur(moteur);
 
-    if (tmp != NULL){
-        tmp->next = *liste;
-        *liste = tmp;
-    }
+        creerFenetre();
+        effaceEcran();
 
-    return tmp;
-}
+        printf("Calcul terminé (%d points écartés par le préfiltre ou la grille)\n", moteur->nbPrefiltre);
 
-void printListePoint(ListePoint liste){
-    for (; liste; liste = liste->next){
-        printf("x: %f, y: %f, adresse: %p\n", liste->p.x, liste->p.y, &(liste->p));
+        dessinePointsNuage(nuage);
+        dessineConvexe(enveloppesMoteur(moteur));
+        MLV_actualise_window();
     }
+
 }
 
 int mouseOnButton(int x, int y, int x_button, int y_button, int widthButton, int heightButton){
@@ -807,29 +666,12 @@ void menu(int *mode, int *forme, int *deroulement){
     }
 }
 
-void freeListes(ListePoint *listePoint, ConvexHull *enveloppe){
-
-    ListePoint p;
-    ListePoint tmp_p = *listePoint;
-    while(tmp_p){
-        p = tmp_p;
-        tmp_p = tmp_p->next;
-        free(p);
-    }
-    *listePoint = NULL;
-    printf("Toutes les cellules de listePoint ont été libérées\n");
+void freeListes(NuagePoints *nuage, Moteur *moteur){
 
-    // FREE CONVEXE
-    
-    Polygon next;
-    Polygon parcours = (*enveloppe).pol;
-    do {
-        next = parcours->next;
-        free(parcours);
-        parcours = next;
-    } while (parcours != (*enveloppe).pol);
+    libereNuage(nuage);
+    printf("Tous les points du nuage ont été libérés\n");
 
-    ((*enveloppe).pol) = NULL;
+    detruitMoteur(moteur);
 
     printf("Tout les polygones ont été libérés\n");
 }
\ No newline at end of file
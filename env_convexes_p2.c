@@ -1,53 +1,19 @@
 #include <stdio.h>
 #include <stdlib.h>
-#include <time.h>
-#include <math.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <MLV/MLV_all.h>
 
+#include "enveloppe.h"
+#include "statique.h"
+#include "rendu.h"
+#include "aleatoire.h"
+
 #define SIZE_X 800
 #define SIZE_Y 800
 #define NB_COULEURS 9
-
-typedef struct s_point{
-    double x;
-    double y;
-} Point;
-
-
-/**
- * @brief Liste chaînée simple pour gérer les points
- * 
- */
-typedef struct s_lst_point{
-    Point p;
-    struct s_lst_point *next;
-} CellulePoint, *ListePoint;
-
-
-/**
- * @brief Structure liste doublement chaînée circulaire d'un vertex contenant l'adresse d'un point 
- * et son vertex suivant et précédent
- * 
- */
-typedef struct _vrtx_{
-    Point *s; /* un point de l’ensemble */
-    struct _vrtx_ *prev; /* le vertex précédent */
-    struct _vrtx_ *next; /* le vertex suivant */
-} Vertex, *Polygon;
-
-
-/**
- * @brief Structure liste chaînée de l'enveloppe convexe contenant un Polygone (Une liste de vertex) 
- * et sa taille actuelle et maximale, ainsi que son enveloppe prochaine
- * 
- */
-typedef struct s_convex{
-    Polygon pol; /* le polygône */
-    struct s_convex *next;
-    int curlen; /* la longueur courante */
-    int maxlen; /* la longueur maximale */
-    MLV_Color couleur;
-} ConvexHull, *ListeConvexe;
+#define MARGE 5 /* rayon des disques des sommets, plus un pixel */
 
 /////////////////////////////////
 // Fonctions fenêtre et dessin //
@@ -56,16 +22,6 @@ typedef struct s_convex{
 void creerFenetre();
 void effaceEcran();
 
-/**
- * @brief Genere un point aléatoirement et qui fait partie de la fenêtre
- * 
- * @param forme 1: Génération aléatoire en forme de cercle 2: Génération aléatoire en forme de carré 
- * @param R Rayon du cercle/carré
- * @param centre Centre du cercle/carré
- * @return Point 
- */
-Point getPoint(int forme, int R, Point centre);
-
 /**
  * @brief Récupère un point après un clic de l'utilisateur
  * 
@@ -84,18 +40,36 @@ void drawPoint(Point p, MLV_Color couleur);
 /**
  * @brief Dessine le polygone donné en paramètre
  * 
- * @param poly Le polygone à dessiner
- * @param curlen La taille actuelle du polygone (nombre de sommets)
+ * @param enveloppe L'enveloppe dont le polygone est à dessiner
  * @param utilisateur Mode du programme (0: Aléatoire; 1: Clic-souris)
  */
-void dessineConvexe(Polygon poly, MLV_Color couleur, int curlen, int utilisateur);
+void dessineConvexe(const ConvexHull *enveloppe, MLV_Color couleur, int utilisateur);
 
 /**
- * @brief Dessine tous les points dans la liste chaînée listePoint sur l'écran
+ * @brief Dessine tous les points du nuage sur l'écran
  * 
- * @param listePoint La liste chaînée de points
+ * @param nuage Le nuage des points
  */
-void dessinePointsListe(ListePoint listePoint);
+void dessinePointsNuage(const NuagePoints *nuage);
+
+/**
+ * @brief Dessine une image d'après un instantané : seule la zone des couches modifiées depuis la
+ * précédente est effacée, et seules les couches qui la coupent y sont redessinées
+ * 
+ * @param instantane L'instantané du moteur
+ * @param utilisateur Mode du programme (0: Aléatoire; 1: Clic-souris)
+ * @param couleurs Liste des couleurs des enveloppes
+ */
+void dessineImage(const Instantane *instantane, int utilisateur, MLV_Color *couleurs);
+
+/**
+ * @brief Publie un instantané du moteur et le dessine aussitôt, depuis le thread du calcul
+ * 
+ * @param moteur Le moteur de calcul
+ * @param utilisateur Mode du programme (0: Aléatoire; 1: Clic-souris)
+ * @param couleurs Liste des couleurs des enveloppes
+ */
+void afficheMoteur(const Moteur *moteur, int utilisateur, MLV_Color *couleurs);
 
 /**
  * @brief Ouvre le menu principal du programme
@@ -119,76 +93,43 @@ void menu(int *mode, int *forme, int *deroulement);
  */
 int mouseOnButton(int x, int y, int x_button, int y_button, int widthButton, int heightButton);
 
-
 /////////////////////////
 // Fonctions de calcul //
 /////////////////////////
 
-/**
- * @brief Renvoie l'orientation d'un triangle
- * 
- * @param Sommet A du triangle
- * @param Sommet B du triangle
- * @param Sommet C du triangle
- * @return 0 si l'orientation est indirecte, 1 sinon
- */
-int orientationTriangle(Point A, Point B, Point C);
-
 /**
  * @brief Genere l'enveloppe convexe initiale de 3 points
  * 
- * @param enveloppe L'adresse de l'enveloppe convexe vide
- * @param listePoint La liste des points vide
+ * @param moteur Le moteur de calcul vide
+ * @param nuage Le nuage des points vide
  * @param utilisateur Mode du programme (0: Aléatoire; 1: Clic-souris)
- * @param nbPoint Nombre de points si aléatoire
  * @param deroulement Mode d'affichage (0: Point par point; 1: Terminal)
  * @param couleurs Liste des couleurs des enveloppes
  */
-void genereEnveloppe(ConvexHull *enveloppe, ListePoint *listePoint, int utilisateur, int nbPoint, int deroulement, MLV_Color *couleurs);
+void genereEnveloppe(Moteur *moteur, NuagePoints *nuage, int utilisateur, int deroulement, MLV_Color *couleurs);
 
 /**
- * @brief Effectue le nettoyage avant de l'enveloppe après insertion, et supprime les vertex qu'il
- * faut supprimer
- * 
- * @param poly Adresse du polygone
- * @param enveloppe Adresse de l'enveloppe
- * @param couleurs Liste des couleurs des enveloppes
+ * @brief Travail du thread de calcul du mode aléatoire
+ *
  */
-void nettoyageAvant2(Polygon *poly, ConvexHull *enveloppe, MLV_Color *couleurs);
+typedef struct{
+    Moteur *moteur; /* le moteur de calcul */
+    NuagePoints *nuage; /* le nuage des points */
+    int nbPoint; /* nombre de points */
+    int choix; /* forme de la génération aléatoire (1: Cercle; 2: Carré) */
+    int deroulement; /* mode d'affichage (0: Point par point; 1: Terminal) */
+    Compteurs compteurs; /* compteurs du thread, recopiés à sa fin */
+    Latences *latences; /* mesures du thread, retirées à sa fin */
+} Calcul;
 
 /**
- * @brief Effectue le nettoyage après de l'enveloppe après insertion, et supprime les vertex qu'il
- * faut supprimer
+ * @brief Tire les points aléatoires ; en mode point par point, les insère un à un et publie un
+ * instantané des couches à chaque image due
  * 
- * @param poly Adresse du polygone
- * @param enveloppe Adresse de l'enveloppe
- * @param couleurs Liste des couleurs des enveloppes
+ * @param arg Le Calcul
+ * @return NULL
  */
-void nettoyageArriere2(Polygon *poly, ConvexHull *enveloppe, MLV_Color *couleurs);
-
-int appartientCercle(Point P, Point centre, int R);
-int appartientCarre(Point P, Point centre, int R);
-
-/**
- * @brief Calcule l'orientation et insère un point dans l'enveloppe à sa place
- * 
- * @param P L'adresse du point à vérifier dans la liste des points
- * @param poly L'adresse du polygone
- * @param enveloppe L'adresse de l'enveloppe convexe
- * @return 0 si pas d'insertion (orientation directe), 1 sinon
- * @param couleurs Liste des couleurs des enveloppes
- */
-int insertionPoint(Point *P, Polygon *poly, ConvexHull *enveloppe, MLV_Color *couleurs);
-
-/**
- * @brief Fonction qui vérifie si un point est à l'exterieur où à l'interieur d'une enveloppe
- * et appele récursivement avec toute la liste des enveloppes
- * 
- * @param P Point à traiter
- * @param listeConvexe La liste des enveloppes
- * @param couleurs Liste des couleurs des enveloppes
- */
-void traitementRecursif(Point *P, ListeConvexe *listeConvexe, MLV_Color *couleurs);
+void *calculeAleatoire(void *arg);
 
 /////////////////////
 // Fonctions start //
@@ -197,56 +138,32 @@ void traitementRecursif(Point *P, ListeConvexe *listeConvexe, MLV_Color *couleur
 /**
  * @brief Commence le programme (mode clic-souris)
  * 
- * @param enveloppe Adresse de l'enveloppe convexe
- * @param listePoint Adresse de la liste de points
+ * @param moteur Le moteur de calcul
+ * @param nuage Adresse du nuage des points
  * @param couleurs Liste des couleurs des enveloppes
  */
-void commenceClic(ConvexHull *enveloppe, ListePoint *listePoint, MLV_Color *couleurs);
+void commenceClic(Moteur *moteur, NuagePoints *nuage, MLV_Color *couleurs);
 
 /**
  * @brief Commence le programme (mode aléatoire)
  * 
- * @param enveloppe Adresse de l'enveloppe convexe
- * @param listePoint Adresse de la liste de points
+ * @param moteur Le moteur de calcul
+ * @param nuage Adresse du nuage des points
  * @param nbPoint Nombre de points
  * @param choix Forme de la génération aléatoire (1: Cercle; 2: Carré)
  * @param deroulement Mode d'affichage (0: Point par point; 1: Terminal)
  * @param couleurs Liste des couleurs des enveloppes
  */
-void commenceAleatoire(ConvexHull *enveloppe, ListePoint *listePoint, int nbPoint , int choix, int deroulement, MLV_Color *couleurs);
-
-/////////////////////////
-// Fonctions enveloppe //
-/////////////////////////
-
-void printConvex(ConvexHull enveloppe);
-void printConvexAdresse(Polygon pol);
-void supprimeVertex(Polygon *poly);
-
-////////////////////////////
-// Fonctions liste points //
-////////////////////////////
-
-ListePoint alloueCellule(Point p);
-ListePoint insereTete(ListePoint *liste, Point p);
-void printListePoint(ListePoint liste);
-
-/////////////////////////////
-// Fonctions liste convexe //
-/////////////////////////////
-
-ListeConvexe alloueCelluleConvexe(Polygon pol);
-void insereQueueConvexe(ListeConvexe *liste, Polygon pol);
-void printListeConvexe(ListeConvexe ListeConvexe);
+void commenceAleatoire(Moteur *moteur, NuagePoints *nuage, int nbPoint , int choix, int deroulement, MLV_Color *couleurs);
 
 /**
- * @brief Libère la liste chaînée de points ainsi que toutes les enveloppes convexes
+ * @brief Libère le nuage des points ainsi que le moteur, toutes ses enveloppes convexes
  * et tous leurs polygones
  * 
- * @param listePoint Adresse de la liste chaînée de points
- * @param listeConvexe Adresse de la liste chaînée des enveloppes
+ * @param nuage Adresse du nuage des points
+ * @param moteur Le moteur de calcul
  */
-void freeListes(ListePoint *listePoint, ListeConvexe *listeConvexe);
+void freeListes(NuagePoints *nuage, Moteur *moteur);
 
 
 /**
@@ -255,14 +172,19 @@ void freeListes(ListePoint *listePoint, ListeConvexe *listeConvexe);
  * @param data Variable arret à modifier par adresse
  */
 void exit_function(void* data){
-    int* arret = (int*) data;
-    *arret = 1;
+    atomic_int* arret = (atomic_int*) data;
+    atomic_store(arret, 1);
 }
 
-// Variable pour vérifier l'arrêt du programme
-int arret = 0;
+// Variable pour vérifier l'arrêt du programme, lue aussi par le thread de calcul du mode aléatoire
+atomic_int arret = 0;
 
-int nbConvexe = 0;
+// Ce qui est à l'écran (mode point par point), et les instantanés publiés par le calcul
+Affichage affichage;
+Echange echange;
+
+// Générateur des points du mode aléatoire (un seul thread tire à la fois)
+Generateur generateur;
 
 int main(void){
     int utilisateur = 0;
@@ -272,7 +194,9 @@ int main(void){
     int lu = 0 ;
 
 
-    srand(time(NULL));
+    uint64_t graine = graineParDefaut();
+    initGenerateur(&generateur, graine, 0);
+    activeTrace(getenv("ENVELOPPE_TRACE") != NULL);
     
     menu(&utilisateur, &forme, &deroulement);
     if (!utilisateur){
@@ -282,6 +206,7 @@ int main(void){
         lu = scanf("%d", &nbPoint);
         while ( (c = getchar()) != '\n' && c != EOF);
     }while (lu == 0);
+    printf("Graine : %" PRIu64 " (ENVELOPPE_GRAINE=%" PRIu64 " rejoue ce tirage)\n", graine, graine);
     }
     
     MLV_execute_at_exit(exit_function, &arret);
@@ -291,6 +216,8 @@ int main(void){
         effaceEcran(); 
         MLV_actualise_window(); 
     }
+    initAffichage(&affichage, SIZE_X, SIZE_Y, MARGE);
+    initEchange(&echange);
 
     // Liste des couleurs de l'enveloppe (alterne entre NB_COULEURS)
     MLV_Color couleurs[NB_COULEURS] = {  
@@ -301,20 +228,25 @@ int main(void){
                                         MLV_rgba(0,0,255,255), MLV_rgba(0,0,175,255), 
                                     };
 
-    Polygon debut = NULL;
-    ConvexHull *listeConvexe = NULL;
-    insereQueueConvexe(&listeConvexe, debut);
-    
-    ListePoint listePoint = NULL;
+    // Le nombre de points est connu en mode aléatoire : le nuage est alloué en une fois
+    NuagePoints nuage;
+    initNuage(&nuage, utilisateur ? 0 : nbPoint);
+
+    Moteur *moteur = creeMoteur(MOTEUR_COUCHES, &nuage);
+    if (!moteur){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    reserveMoteur(moteur, nbPoint + 3);
     
-    genereEnveloppe(listeConvexe, &listePoint, utilisateur, nbPoint, deroulement, couleurs);
+    genereEnveloppe(moteur, &nuage, utilisateur, deroulement, couleurs);
 
     if (utilisateur){
-        commenceClic(listeConvexe, &listePoint, couleurs);
+        commenceClic(moteur, &nuage, couleurs);
     }
     else{        
         // Cercle = 1; Carré = 2
-        commenceAleatoire(listeConvexe, &listePoint, nbPoint, forme, deroulement, couleurs);
+        commenceAleatoire(moteur, &nuage, nbPoint, forme, deroulement, couleurs);
     }
 
 
@@ -324,7 +256,13 @@ int main(void){
         }
     }
 
-    freeListes(&listePoint, &listeConvexe);
+    afficheCompteurs(stdout, enveloppesMoteur(moteur));
+    afficheLatences(stdout);
+    ecritTraceLatences(getenv("ENVELOPPE_TRACE"));
+
+    freeListes(&nuage, moteur);
+    libereAffichage(&affichage);
+    libereEchange(&echange);
     MLV_free_window();
 
     return 0;
@@ -335,7 +273,6 @@ void creerFenetre(){
 }
 
 Point getPointOnClic(){
-    double PERTURB = 0.0001/RAND_MAX;
     Point P;
     int x = -1; int y = -1;
     
@@ -343,8 +280,9 @@ Point getPointOnClic(){
         MLV_wait_mouse_or_seconds(&x,&y, 1);
     }
     
-    P.x = x + (rand()%2 ? +1. : -1.)*PERTURB*rand();
-    P.y = y + (rand()%2 ? +1. : -1.)*PERTURB*rand();
+    // Le prédicat d'orientation est exact : les points alignés n'ont pas besoin d'être perturbés
+    P.x = x;
+    P.y = y;
 
     return P;
 }
@@ -354,219 +292,60 @@ void drawPoint(Point p, MLV_Color couleur){
     MLV_actualise_window();
 }
 
-int orientationTriangle(Point A, Point B, Point C){
-    return (B.x - A.x) * (C.y - A.y) - (C.x - A.x) * (B.y - A.y);
-}
-
-Polygon newCell(Point *P){
-    Polygon poly;
-    poly = (Polygon) malloc(sizeof(Vertex));
-    if (!poly){ 
-        fprintf(stderr,"Plus de memoire "); 
-        exit(-1);
-    }
-    poly->s = P;
-    poly->next = poly->prev = poly;
-
-    return poly;
-}
-
-void addBefore(Polygon poly, Polygon ins, Polygon *head){
-    
-    if (!poly)
-       { *head = ins; return ;}
-    ins->next = poly;
-    ins->prev = poly->prev;
-    poly->prev = ins ;
-    if (! ins->prev)
-    { *head = ins; }
-    else 
-    { 
-    ins->prev->next = ins ;
-    }
-
-} 
-
-void addAfter(Polygon after, Polygon ins, Polygon *head){
-    if (! after){ // empty list
-        *head = ins; 
-       return ;
-       }
-    ins->next = after->next;
-    if (after->next)  ins->next->prev = ins ;
-    ins->prev = after;
-    after->next = ins ;
-} 
-
-void printConvex(ConvexHull enveloppe){ 
-    if (enveloppe.pol != NULL){
-        Point *premierPoint = enveloppe.pol->s;
-        printf("x: %f, y: %f\n", (enveloppe.pol->s)->x, (enveloppe.pol->s)->y);
-        enveloppe.pol = enveloppe.pol->next;
-        
-        
-        for(; enveloppe.pol->s != premierPoint ; enveloppe.pol = enveloppe.pol->next){
-            printf("x: %f, y: %f\n", (enveloppe.pol->s)->x, (enveloppe.pol->s)->y);
-        }
-        
-        printf("\n");
-    }
-}
-
-void printConvexAdresse(Polygon pol){ 
-    if (pol != NULL){
-        Point *premierPoint = pol->s;
-        printf("x: %f, y: %f, ADRESSE P: %p, ADRESSE: %p,  ADRESSE PREV: %p, ADRESSE NEXT: %p\n", (pol->s)->x, (pol->s)->y, pol->s , pol, pol->prev, pol->next);
-        pol = pol->next;
-        
-        
-        for(; pol->s != premierPoint ; pol = pol->next){
-            printf("x: %f, y: %f, ADRESSE P: %p, ADRESSE: %p,  ADRESSE PREV: %p, ADRESSE NEXT: %p\n", (pol->s)->x, (pol->s)->y, pol->s , pol, pol->prev, pol->next);
-        }
-        
-        printf("\n");
-    }
-}
-
-
-int appartientCercle(Point P, Point centre, int R){
-    return ((int)((P.x - centre.x)*(P.x - centre.x)) + ((P.y - centre.y)*(P.y - centre.y)) <= (int)R*R);
-}
-
-int appartientCarre(Point P, Point centre, int R){
-    return ((int)fabs((P.x - centre.x)+(P.y - centre.y)) + (int)fabs((P.x - centre.x) - (P.y - centre.y)) <= (int)R*2);
-}
-
-Point getPoint(int forme, int R, Point centre){
-    Point P;
-    
-    // Cercle
-    if (forme == 1){
-        do{
-            P.x = centre.x - R + (rand() % (2*R));
-            P.y = centre.y - R + (rand() % (2*R));
-        } while(!appartientCercle(P, centre, R));
-    }
-    // Carré
-    else{
-        do{
-            P.x = centre.x - R + (rand() % (2*R));
-            P.y = centre.y - R + (rand() % (2*R));
-        } while(!appartientCarre(P, centre, R));
-    }
-    
-    return P;
-}
-
-void genereEnveloppe(ConvexHull *enveloppe, ListePoint *listePoint, int utilisateur, int nbPoint, int deroulement, MLV_Color *couleurs){
-    enveloppe->curlen = 0;
-    enveloppe->couleur = couleurs[nbConvexe % NB_COULEURS];
-    
+void genereEnveloppe(Moteur *moteur, NuagePoints *nuage, int utilisateur, int deroulement, MLV_Color *couleurs){
     Point P0, P1, P2;
     
     if (!utilisateur){
-        enveloppe->maxlen = nbPoint;
-
         Point centre; centre.x = SIZE_X/2; centre.y = SIZE_Y/2;
 
-        P0 = getPoint(1, 5, centre);
-        P1 = getPoint(1, 5, centre);
-        P2 = getPoint(1, 5, centre);
+        Tirage tirage;
+        initTirage(&tirage);
+        prepareTirage(&tirage, FORME_CERCLE, 5, centre);
+        P0 = tirePoint(&generateur, &tirage);
+        P1 = tirePoint(&generateur, &tirage);
+        P2 = tirePoint(&generateur, &tirage);
+        libereTirage(&tirage);
     }
     else{
-        enveloppe->maxlen = 0;
-
         P0 = getPointOnClic();
-        drawPoint(P0, enveloppe->couleur);
+        drawPoint(P0, couleurs[0]);
         P1 = getPointOnClic();
-        drawPoint(P1, enveloppe->couleur);
+        drawPoint(P1, couleurs[0]);
         P2 = getPointOnClic();
-        drawPoint(P2, enveloppe->couleur);
-    }
-    
-    if(orientationTriangle(P0,P1,P2) >= 0){
-        insereTete(listePoint, P2);
-        if (!listePoint) { return; }
-        insereTete(listePoint, P1);
-        if (!listePoint) { return; }
-        insereTete(listePoint, P0);
-        if (!listePoint) { return; }
-    }
-    else if(orientationTriangle(P0,P2,P1) >= 0){
-        insereTete(listePoint, P1);
-        if (!listePoint) { return; }
-        insereTete(listePoint, P2);
-        if (!listePoint) { return; }
-        insereTete(listePoint, P0);
-        if (!listePoint) { return; }
+        drawPoint(P2, couleurs[0]);
     }
-
-    enveloppe->maxlen = 3;
-
     
-    ListePoint parcours = *listePoint;
-    for (; parcours ; parcours = parcours->next){
-        Polygon poly = newCell(&(parcours->p));
-        addBefore(enveloppe->pol, poly, &enveloppe->pol);
-    }
-
-    enveloppe->curlen = 3;
-    nbConvexe += 1;
+    // Le moteur oriente lui-même le triangle initial
+    insereMoteur(moteur, ajoutePoint(nuage, P0));
+    insereMoteur(moteur, ajoutePoint(nuage, P1));
+    insereMoteur(moteur, ajoutePoint(nuage, P2));
 
     if (deroulement == 0 && !arret){
-        dessineConvexe(enveloppe->pol, enveloppe->couleur, enveloppe->curlen, utilisateur);
-    }
-}
-
-int insertionPoint(Point *P, Polygon *poly, ConvexHull *enveloppe, MLV_Color *couleurs){
-    Point *premierPoint = (*poly)->s;
-    Polygon copy = *poly;
-    int orientation;
-    
-    do{
-        Point P1 = *((copy)->s);
-        Point P2 = *((copy)->next->s);
-
-        orientation = orientationTriangle(*P, P1, P2);
-        
-        (copy) = (copy)->next;
-    } while ((copy)->s != premierPoint && orientation >= 0);
-
-
-    if (orientation < 0){
-        Polygon ins = newCell(P);
-        addBefore(copy, ins, &((copy)));
-        copy = copy->prev ;
-        enveloppe->curlen += 1;
-        nettoyageAvant2(&(copy), enveloppe, couleurs);
-        nettoyageArriere2(&(copy), enveloppe, couleurs);
-        enveloppe->pol = copy ;
-        
-        return 1;
+        afficheMoteur(moteur, utilisateur, couleurs);
     }
-
-
-    return 0;
 }
 
 void effaceEcran(){
     MLV_clear_window(MLV_COLOR_WHITE);
 }
 
-void dessineConvexe(Polygon poly, MLV_Color couleur, int curlen, int utilisateur){
+void dessineConvexe(const ConvexHull *enveloppe, MLV_Color couleur, int utilisateur){
+    uint64_t debut = debutLatence();
     Uint8 r; Uint8 g; Uint8 b; Uint8 a;
     MLV_convert_color_to_rgba(couleur, &r, &g, &b, &a);
     MLV_Color couleurTransparente = MLV_convert_rgba_to_color(r, g, b, 64);
     MLV_Color couleurLigne = MLV_convert_rgba_to_color(r, g, b, 80);
 
 
-    Point *premierPoint = poly->s;
+    const Vertex *anneau = enveloppe->anneau;
+    int curlen = enveloppe->curlen;
+    int poly = enveloppe->pol;
     int tab_x[curlen]; int tab_y[curlen];
     
     int i = 0;
     do{
-        Point P0 = (*poly->s);
-        Point P1 = (*poly->next->s);
+        Point P0 = anneau[poly].p;
+        Point P1 = anneau[anneau[poly].next].p;
         if (utilisateur){
             MLV_draw_filled_circle(P0.x, P0.y, 4, couleur);
             MLV_draw_filled_circle(P1.x, P1.y, 4, couleur);
@@ -578,186 +357,170 @@ void dessineConvexe(Polygon poly, MLV_Color couleur, int curlen, int utilisateur
             tab_y[i] = P0.y;
         }
 
-        poly = poly->next;
+        poly = anneau[poly].next;
         i += 1;
-    } while (poly->s != premierPoint);
+    } while (poly != enveloppe->pol);
 
     if (curlen >= 3){
         MLV_draw_filled_polygon(tab_x, tab_y, curlen, couleurTransparente);
     }
 
-    MLV_actualise_window();
+    finLatence(LATENCE_DESSIN, debut);
 }
 
-void dessinePointsListe(ListePoint listePoint){
+void dessinePointsNuage(const NuagePoints *nuage){
 
-    for(; listePoint; listePoint = listePoint->next){
-        MLV_draw_filled_circle(listePoint->p.x, listePoint->p.y, 4, MLV_COLOR_BLACK);
+    for(int i = 0; i < nuage->nbPoint; i++){
+        MLV_draw_filled_circle(nuage->x[i], nuage->y[i], 4, MLV_COLOR_BLACK);
     }
 
 }
 
-void commenceClic(ConvexHull *enveloppe, ListePoint *listePoint, MLV_Color *couleurs){
-    
-    ConvexHull *parcours;
-    while (!(arret)){
-        parcours = enveloppe;
-        
-        Point P = getPointOnClic();
+void dessineImage(const Instantane *instantane, int utilisateur, MLV_Color *couleurs){
+    Zone zone;
 
-        insereTete(listePoint, P);
-        
-        if (listePoint && !arret){
-            traitementRecursif(&((*listePoint)->p), &enveloppe, couleurs);
-            
-            effaceEcran();
-            for (; parcours; parcours = parcours->next){
-                dessineConvexe(parcours->pol, parcours->couleur, parcours->curlen, 1);
-            }
-        }
+    if (!zoneModifiee(&affichage, instantane, &zone)){
+        return;
     }
-    
-}
 
-void nettoyageAvant2(Polygon *poly, ConvexHull *enveloppe, MLV_Color *couleurs){
-    Point *sauvegarde;
-    Point P = *((*poly)->s );
-    Point P1 = *((*poly)->next->s );
-    Point P2 = *((*poly)->next->next->s );
-    
-    while(orientationTriangle(P,P1,P2) <= 0 ){
-        
-        Polygon adresseSupp = (*poly)->next;
-        
-        (*poly)->next = (*poly)->next->next;
-        (*poly)->next->prev = (*poly);
-        
-        sauvegarde = adresseSupp->s;
-        free(adresseSupp);
-        
-        enveloppe->curlen -= 1 ;
+    // Les couches sont transparentes : une couche qui coupe la zone y est contenue, et y est
+    // redessinée en entier sur le fond effacé ; les autres restent telles quelles
+    MLV_draw_filled_rectangle(zone.x0, zone.y0, zone.x1 - zone.x0, zone.y1 - zone.y0, MLV_COLOR_WHITE);
 
-        traitementRecursif(sauvegarde, &(enveloppe->next), couleurs);
-        
-        P1 = *((*poly)->next->s );
-        P2 = *((*poly)->next->next->s );
+    int rang = 0;
+    for (const ConvexHull *parcours = premiereCouche(instantane); parcours; parcours = parcours->next, rang++){
+        if ((utilisateur || parcours->curlen >= 3) && intersecteZones(&zone, boiteCouche(&affichage, rang))){
+            dessineConvexe(parcours, couleurs[parcours->numero % NB_COULEURS], utilisateur);
+        }
     }
+
+    MLV_actualise_window();
 }
 
-void nettoyageArriere2(Polygon *poly, ConvexHull *enveloppe, MLV_Color *couleurs){
-    Point *sauvegarde;
-    Point P = *((*poly)->s );
-    Point P1 = *((*poly)->prev->prev->s );
-    Point P2 = *((*poly)->prev->s );
-    
-    while(orientationTriangle(P,P1,P2) <= 0 ){
-        
-        Polygon adresseSupp = (*poly)->prev;
+void afficheMoteur(const Moteur *moteur, int utilisateur, MLV_Color *couleurs){
+    publieInstantane(&echange, moteur, NULL);
+    dessineImage(prendInstantane(&echange), utilisateur, couleurs);
+}
 
-        (*poly)->prev = (*poly)->prev->prev;
-        (*poly)->prev->next = (*poly);
-        
-        sauvegarde = adresseSupp->s;
-        free(adresseSupp);
 
-        enveloppe->curlen -= 1 ;
+void commenceClic(Moteur *moteur, NuagePoints *nuage, MLV_Color *couleurs){
+    
+    while (!(arret)){
+        Point P = getPointOnClic();
 
-        traitementRecursif(sauvegarde, &(enveloppe->next), couleurs);
+        int indice = ajoutePoint(nuage, P);
         
-        P1 = *((*poly)->prev->prev->s );
-        P2 = *((*poly)->prev->s );
+        if (!arret){
+            insereMoteur(moteur, indice);
+            afficheMoteur(moteur, 1, couleurs);
+        }
     }
+    
 }
 
-void commenceAleatoire(ConvexHull *enveloppe, ListePoint *listePoint, int nbPoint , int choix, int deroulement, MLV_Color *couleurs){
+void *calculeAleatoire(void *arg){
+    Calcul *calcul = (Calcul *) arg;
     Point centre; centre.x = SIZE_X/2; centre.y = SIZE_Y/2;
 
     double rayonplus = 2;
+    Tirage tirage;
+    initTirage(&tirage);
 
-    if (deroulement == 1){
-        printf("Calcul en cours...\n");
+    // Les insertions faites entre deux images sont publiées ensemble
+    Cadence cadence;
+    initCadence(&cadence, IMAGES_PAR_SECONDE);
+
+    if (calcul->deroulement == 0){
+        activeTrace(getenv("ENVELOPPE_TRACE") != NULL);
     }
-    
-    ConvexHull *parcours;
-    for(int i = 3 ; (i < nbPoint) && !arret; i++ ){
-        parcours = enveloppe;
-        
+
+    for(int i = 3 ; (i < calcul->nbPoint) && !arret; i++ ){
         if (rayonplus <= ((SIZE_X/2) - 5)){
             rayonplus += 1; 
         }
 
         Point P;
-        P = getPoint(choix, rayonplus, centre);
+        // La table du disque n'est refaite que quand le rayon change
+        if (tirage.rayon != (int) rayonplus){
+            prepareTirage(&tirage, calcul->choix, rayonplus, centre);
+        }
+        P = tirePoint(&generateur, &tirage);
         
-        insereTete(listePoint, P);
+        int indice = ajoutePoint(calcul->nuage, P);
         
-        if (deroulement == 0){
-            traitementRecursif(&((*listePoint)->p), &enveloppe, couleurs);
-            
-            effaceEcran();
-            
-            for (; parcours; parcours = parcours->next){
-                if (parcours->curlen >= 3){
-                    dessineConvexe(parcours->pol, parcours->couleur, parcours->curlen, 0);
-                }
+        if (calcul->deroulement == 0){
+            insereMoteur(calcul->moteur, indice);
+
+            if (imageDue(&cadence)){
+                publieInstantane(&echange, calcul->moteur, NULL);
             }
         }
     }
 
-    if (deroulement == 1){
-        ListePoint parcours = (*listePoint);
+    if (calcul->deroulement == 0){
+        publieInstantane(&echange, calcul->moteur, NULL);
+        termineEchange(&echange);
 
-        for (; parcours->next; parcours = parcours->next){
-            traitementRecursif(&(parcours->p), &enveloppe, couleurs);
-        }
+        // Les mesures du thread disparaissent avec lui
+        calcul->compteurs = compteurs;
+        calcul->latences = detacheLatences();
+    }
 
-        creerFenetre();
+    libereTirage(&tirage);
 
-        printf("Calcul terminé\n");
+    return NULL;
+}
 
-        effaceEcran();
+void commenceAleatoire(Moteur *moteur, NuagePoints *nuage, int nbPoint , int choix, int deroulement, MLV_Color *couleurs){
+    Calcul calcul;
+    calcul.moteur = moteur;
+    calcul.nuage = nuage;
+    calcul.nbPoint = nbPoint;
+    calcul.choix = choix;
+    calcul.deroulement = deroulement;
 
-        ConvexHull *parcoursEnv = enveloppe;
-        for (; parcoursEnv; parcoursEnv = parcoursEnv->next){
-            if (parcoursEnv->curlen >= 3){
-                dessineConvexe(parcoursEnv->pol, parcoursEnv->couleur, parcoursEnv->curlen, 0);
-            }
+    if (deroulement == 0){
+        // Le calcul a son thread : celui-ci ne fait que dessiner le dernier instantané publié
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, calculeAleatoire, &calcul)){
+            fprintf(stderr,"Creation de thread impossible ");
+            exit(-1);
         }
-        MLV_actualise_window();
-    }
-
-}
-
-ListePoint alloueCellule(Point p){
-    ListePoint tmp;
 
-    tmp = (CellulePoint *) malloc(sizeof(CellulePoint));
+        const Instantane *instantane;
+        while ((instantane = attendInstantane(&echange))){
+            if (!arret){
+                dessineImage(instantane, 0, couleurs);
+            }
+        }
 
-    if (tmp != NULL){
-        tmp->p = p;
-        tmp->next = NULL;
+        pthread_join(thread, NULL);
+        ajouteCompteurs(&(calcul.compteurs));
+        rattacheLatences(calcul.latences, 2);
     }
 
-    return tmp;
-}
+    if (deroulement == 1){
+        printf("Calcul en cours...\n");
+        calculeAleatoire(&calcul);
 
-ListePoint insereTete(ListePoint *liste, Point p){
-    ListePoint tmp;
+        // Tous les points sont connus : calcul statique au lieu d'une insertion par point
+        construitMoteur(moteur);
 
-    tmp = alloueCellule(p);
+        creerFenetre();
 
-    if (tmp != NULL){
-        tmp->next = *liste;
-        *liste = tmp;
-    }
+        printf("Calcul terminé\n");
 
-    return tmp;
-}
+        effaceEcran();
 
-void printListePoint(ListePoint liste){
-    for (; liste; liste = liste->next){
-        printf("x: %f, y: %f, adresse: %p\n", liste->p.x, liste->p.y, &(liste->p));
+        ConvexHull *parcoursEnv = enveloppesMoteur(moteur);
+        for (; parcoursEnv; parcoursEnv = parcoursEnv->next){
+            if (parcoursEnv->curlen >= 3){
+                dessineConvexe(parcoursEnv, couleurs[parcoursEnv->numero % NB_COULEURS], 0);
+            }
+        }
+        MLV_actualise_window();
     }
+
 }
 
 int mouseOnButton(int x, int y, int x_button, int y_button, int widthButton, int heightButton){
@@ -877,124 +640,12 @@ void menu(int *mode, int *forme, int *deroulement){
     }
 }
 
-ListeConvexe alloueCelluleConvexe(Polygon pol){
-    ConvexHull *newHull;
-
-    newHull = (ConvexHull *) malloc(sizeof(ConvexHull));
+void freeListes(NuagePoints *nuage, Moteur *moteur){
 
-    if (newHull){
-        newHull->pol = pol;
-        newHull->next = NULL;
-    }
-
-    return newHull;
-}
+    libereNuage(nuage);
+    printf("Tous les points du nuage ont été libérés\n");
 
-void insereQueueConvexe(ListeConvexe *liste, Polygon pol){
-    ConvexHull *newHull = alloueCelluleConvexe(pol);
-    ListeConvexe parcours = *liste;
-    
-    if (newHull){
-        if(*liste == NULL){
-            *liste = newHull;
-        }
-        else{
-            for(; parcours->next; parcours = parcours->next);
-
-            parcours->next = newHull ;
-        }
-    }
-}
-
-void printListeConvexe(ListeConvexe listeConvexe){
-    int i = 0;
-    for (; listeConvexe; listeConvexe = listeConvexe->next){
-        printf("CONV %d, adresse: %p\n", i, listeConvexe);
-        printConvexAdresse(listeConvexe->pol);
-        i += 1;
-    }
-}
-
-void traitementRecursif(Point *P, ListeConvexe *listeConvexe, MLV_Color *couleurs){
-    if (*listeConvexe == NULL){
-        Polygon ins = newCell(P);
-        insereQueueConvexe(listeConvexe, ins);
-
-        (*listeConvexe)->curlen = 1;
-        (*listeConvexe)->couleur = couleurs[nbConvexe % NB_COULEURS];
-        nbConvexe += 1;
-
-        return;
-    }
-    if ((*listeConvexe)->curlen == 1){
-        Polygon ins = newCell(P);
-        addBefore((*listeConvexe)->pol, ins, &((*listeConvexe)->pol));
-        // addAfter((*listeConvexe)->pol, ins, &((*listeConvexe)->pol));
-
-        (*listeConvexe)->curlen += 1;
-
-        return;
-    }
-    if ((*listeConvexe)->curlen == 2){
-        Point P0 = *((*listeConvexe)->pol->s);
-        Point P1 = *((*listeConvexe)->pol->next->s);
-        Point P2 = *P;
-        
-        Polygon ins = newCell(P);
-        if(orientationTriangle(P0,P1,P2) >= 0){
-            addAfter((*listeConvexe)->pol->next, ins, &((*listeConvexe)->pol->next));
-        }
-        else if(orientationTriangle(P0,P2,P1) >= 0){
-            addBefore((*listeConvexe)->pol->next, ins, &((*listeConvexe)->pol->next));
-        }
-
-        (*listeConvexe)->curlen += 1;
-        (*listeConvexe)->maxlen = 3;
-
-        return;
-    }
-
-    int insertion = insertionPoint(P, &((*listeConvexe)->pol), *listeConvexe, couleurs);
-    if (!insertion){
-        traitementRecursif(P, &((*listeConvexe)->next), couleurs);
-    }
-}
-
-void freeListes(ListePoint *listePoint, ListeConvexe *listeConvexe){
-
-    ListePoint p;
-    ListePoint tmp_p = *listePoint;
-    while(tmp_p){
-        p = tmp_p;
-        tmp_p = tmp_p->next;
-        free(p);
-    }
-    *listePoint = NULL;
-    printf("Toutes les cellules de listePoint ont été libérées\n");
-
-    // FREE CONVEXE
-    
-    ListeConvexe c;
-    ListeConvexe tmp_c = *listeConvexe;
-    
-    Polygon next;
-    Polygon parcours;
-    while(tmp_c){
-        parcours = tmp_c->pol;
-        do {
-            next = parcours->next;
-            free(parcours);
-            parcours = next;
-        } while (parcours != tmp_c->pol);
-
-        (tmp_c->pol) = NULL;
-
-        // Free liste
-        c = tmp_c;
-        tmp_c = tmp_c->next;
-        free(c);
-        (*listeConvexe) = NULL;
-    }
+    detruitMoteur(moteur);
 
     printf("Tout les polygones et les enveloppes ont été libérés\n");
 }
\ No newline at end of file
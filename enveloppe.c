@@ -0,0 +1,822 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "enveloppe.h"
+
+//////////////////////
+// Fonctions moteur //
+//////////////////////
+
+Moteur *creeMoteur(int options, const NuagePoints *nuage){
+    Moteur *moteur = (Moteur *) malloc(sizeof(Moteur));
+
+    if (moteur){
+        moteur->nuage = nuage;
+        moteur->listeConvexe = NULL;
+        moteur->options = options;
+        moteur->nbConvexe = 0;
+        moteur->nbPrefiltre = 0;
+        moteur->nbThread = 1;
+        moteur->largeurGrille = 0;
+        moteur->version = 0;
+        initPool(&(moteur->noeuds), sizeof(NoeudAngle), 0);
+    }
+
+    return moteur;
+}
+
+void reserveMoteur(Moteur *moteur, int nbPoint){
+    // Une seule enveloppe recycle ses noeuds : quelques blocs suffisent
+    int parBloc = (moteur->options & MOTEUR_COUCHES) ? nbPoint : nbPoint / 64;
+
+    if (parBloc < POOL_BLOC_MIN){
+        parBloc = POOL_BLOC_MIN;
+    }
+
+    if (!moteur->noeuds.blocs){
+        moteur->noeuds.parBloc = parBloc;
+    }
+}
+
+int insereMoteur(Moteur *moteur, int P){
+    ConvexHull *premiere = moteur->listeConvexe;
+    int insertion = 1;
+    uint64_t debut = debutLatence();
+
+    compteDebutInsertion();
+    moteur->version += 1;
+
+    if (premiere && premiere->curlen >= 3){
+        insertion = insertionPoint(P, premiere, moteur);
+
+        if (!insertion && (moteur->options & MOTEUR_COUCHES)){
+            traitementRecursif(P, &(premiere->next), moteur);
+        }
+    }
+    else{
+        traitementRecursif(P, &(moteur->listeConvexe), moteur);
+    }
+
+    compteFinInsertion();
+    finLatence(LATENCE_INSERTION, debut);
+
+    return insertion;
+}
+
+ListeConvexe enveloppesMoteur(const Moteur *moteur){
+    return moteur->listeConvexe;
+}
+
+void detruitMoteur(Moteur *moteur){
+    if (moteur){
+        freeListeConvexe(&(moteur->listeConvexe));
+        liberePool(&(moteur->noeuds));
+        free(moteur);
+    }
+}
+
+/////////////////////////
+// Fonctions de calcul //
+/////////////////////////
+
+/*
+ * Partie exacte du prédicat d'orientation (voir orientationTriangle dans enveloppe.h), d'après
+ * Shewchuk : les nombres sont représentés exactement par des expansions, sommes de doubles
+ * sans chevauchement rangés par grandeur croissante.
+ */
+
+/**
+ * @brief Ajoute b à l'expansion e, en place, en éliminant les composantes nulles
+ *
+ * @return Le nouveau nombre de composantes (au plus n + 1)
+ */
+static int ajouteExpansion(double *e, int n, double b){
+    double q = b;
+    int k = 0;
+
+    for (int i = 0; i < n; i++){
+        // Somme exacte de q et e[i] : arrondi dans somme, erreur d'arrondi dans erreur
+        double somme = q + e[i];
+        double bv = somme - q;
+        double erreur = (q - (somme - bv)) + (e[i] - bv);
+
+        if (erreur != 0){
+            e[k++] = erreur;
+        }
+        q = somme;
+    }
+
+    if (q != 0 || k == 0){
+        e[k++] = q;
+    }
+
+    return k;
+}
+
+/**
+ * @brief Renvoie l'erreur d'arrondi de la différence a - b = d
+ */
+static double erreurDifference(double a, double b, double d){
+    double bv = a - d;
+    return (a - (d + bv)) + (bv - b);
+}
+
+int orientationExacte(Point A, Point B, Point C){
+    double acx = A.x - C.x;
+    double bcx = B.x - C.x;
+    double acy = A.y - C.y;
+    double bcy = B.y - C.y;
+    double e[12];
+    int n = 0;
+
+    if (erreurDifference(A.x, C.x, acx) == 0 && erreurDifference(B.x, C.x, bcx) == 0
+        && erreurDifference(A.y, C.y, acy) == 0 && erreurDifference(B.y, C.y, bcy) == 0){
+        // Différences exactes (cas courant, coordonnées entières par exemple) : deux produits,
+        // chacun représenté exactement par son arrondi et son erreur (fma)
+        double gauche = acx * bcy;
+        double droite = acy * bcx;
+        double erreurGauche = fma(acx, bcy, -gauche);
+        double erreurDroite = fma(acy, bcx, -droite);
+
+        // Produits exacts aussi : le signe de la différence arrondie est exact
+        if (erreurGauche == 0 && erreurDroite == 0){
+            return (gauche > droite) - (gauche < droite);
+        }
+
+        n = ajouteExpansion(e, n, erreurGauche);
+        n = ajouteExpansion(e, n, -erreurDroite);
+        n = ajouteExpansion(e, n, gauche);
+        n = ajouteExpansion(e, n, -droite);
+    }
+    else{
+        // Cas général : déterminant développé en six produits des coordonnées d'origine
+        double a[6] = { B.x, -B.x, -A.x, -C.x, C.x, A.x };
+        double b[6] = { C.y, A.y, C.y, B.y, A.y, B.y };
+
+        for (int i = 0; i < 6; i++){
+            double produit = a[i] * b[i];
+            n = ajouteExpansion(e, n, fma(a[i], b[i], -produit));
+            n = ajouteExpansion(e, n, produit);
+        }
+    }
+
+    // La composante la plus grande donne le signe de la somme
+    return (e[n - 1] > 0) - (e[n - 1] < 0);
+}
+
+int appartientCercle(Point P, Point centre, int R){
+    return ((int)((P.x - centre.x)*(P.x - centre.x)) + ((P.y - centre.y)*(P.y - centre.y)) <= (int)R*R);
+}
+
+int appartientCarre(Point P, Point centre, int R){
+    return ((int)fabs((P.x - centre.x)+(P.y - centre.y)) + (int)fabs((P.x - centre.x) - (P.y - centre.y)) <= (int)R*2);
+}
+
+Point getPoint(int forme, int R, Point centre){
+    Point P;
+
+    // Cercle
+    if (forme == 1){
+        do{
+            P.x = centre.x - R + (rand() % (2*R));
+            P.y = centre.y - R + (rand() % (2*R));
+        } while(!appartientCercle(P, centre, R));
+    }
+    // Carré
+    else{
+        do{
+            P.x = centre.x - R + (rand() % (2*R));
+            P.y = centre.y - R + (rand() % (2*R));
+        } while(!appartientCarre(P, centre, R));
+    }
+
+    return P;
+}
+
+int insertionPoint(int P, ConvexHull *enveloppe, Moteur *moteur){
+    Point Q = pointNuage(moteur->nuage, P);
+    int copy = enveloppe->pol;
+
+    if (enveloppe->index){
+        copy = localiseIndex(enveloppe, Q);
+
+        if (copy < 0){
+            return 0;
+        }
+    }
+    else{
+        const Vertex *anneau = enveloppe->anneau;
+        int premier = enveloppe->pol;
+        int orientation;
+
+        do{
+            Point P1 = anneau[copy].p;
+            Point P2 = anneau[anneau[copy].next].p;
+
+            orientation = orientationTriangle(Q, P1, P2);
+
+            copy = anneau[copy].next;
+        } while (copy != premier && orientation >= 0);
+
+        if (orientation >= 0){
+            return 0;
+        }
+    }
+
+    int ins = newCell(enveloppe, Q, P);
+    addBefore(enveloppe, copy, ins);
+    enveloppe->curlen += 1;
+    nettoyageAvant2(ins, enveloppe, moteur);
+    nettoyageArriere2(ins, enveloppe, moteur);
+    enveloppe->pol = ins;
+    enveloppe->modification = moteur->version;
+
+    // Le nouveau vertex est indexé une fois ses voisins masqués supprimés
+    if (enveloppe->index){
+        insereIndex(enveloppe, ins, &(moteur->noeuds));
+    }
+
+    if (enveloppe->curlen > enveloppe->maxlen){
+        enveloppe->maxlen = enveloppe->curlen;
+    }
+
+    return 1;
+}
+
+void nettoyageAvant2(int v, ConvexHull *enveloppe, Moteur *moteur){
+    Vertex *anneau = enveloppe->anneau;
+    int sauvegarde;
+    Point P = anneau[v].p;
+    Point P1 = anneau[anneau[v].next].p;
+    Point P2 = anneau[anneau[anneau[v].next].next].p;
+
+    while(orientationTriangle(P,P1,P2) <= 0 ){
+
+        int supp = anneau[v].next;
+
+        anneau[v].next = anneau[supp].next;
+        anneau[anneau[v].next].prev = v;
+
+        if (enveloppe->index){
+            supprimeIndex(enveloppe, supp, &(moteur->noeuds));
+        }
+
+        sauvegarde = enveloppe->point[supp];
+        rendCell(enveloppe, supp);
+
+        enveloppe->curlen -= 1 ;
+        COMPTE(evictionsAvant);
+
+        if (moteur->options & MOTEUR_COUCHES){
+            traitementRecursif(sauvegarde, &(enveloppe->next), moteur);
+        }
+
+        P1 = anneau[anneau[v].next].p;
+        P2 = anneau[anneau[anneau[v].next].next].p;
+    }
+}
+
+void nettoyageArriere2(int v, ConvexHull *enveloppe, Moteur *moteur){
+    Vertex *anneau = enveloppe->anneau;
+    int sauvegarde;
+    Point P = anneau[v].p;
+    Point P1 = anneau[anneau[anneau[v].prev].prev].p;
+    Point P2 = anneau[anneau[v].prev].p;
+
+    while(orientationTriangle(P,P1,P2) <= 0 ){
+
+        int supp = anneau[v].prev;
+
+        anneau[v].prev = anneau[supp].prev;
+        anneau[anneau[v].prev].next = v;
+
+        if (enveloppe->index){
+            supprimeIndex(enveloppe, supp, &(moteur->noeuds));
+        }
+
+        sauvegarde = enveloppe->point[supp];
+        rendCell(enveloppe, supp);
+
+        enveloppe->curlen -= 1 ;
+        COMPTE(evictionsArriere);
+
+        if (moteur->options & MOTEUR_COUCHES){
+            traitementRecursif(sauvegarde, &(enveloppe->next), moteur);
+        }
+
+        P1 = anneau[anneau[anneau[v].prev].prev].p;
+        P2 = anneau[anneau[v].prev].p;
+    }
+}
+
+void traitementRecursif(int P, ListeConvexe *listeConvexe, Moteur *moteur){
+    Point Q = pointNuage(moteur->nuage, P);
+
+    compteEntreeCascade();
+    uint64_t debut = debutCascade();
+
+    if (*listeConvexe == NULL){
+        insereQueueConvexe(listeConvexe);
+        if (!*listeConvexe){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+
+        (*listeConvexe)->pol = newCell(*listeConvexe, Q, P);
+        (*listeConvexe)->curlen = 1;
+        (*listeConvexe)->maxlen = 1;
+        (*listeConvexe)->numero = moteur->nbConvexe;
+        (*listeConvexe)->modification = moteur->version;
+        moteur->nbConvexe += 1;
+
+        compteSortieCascade();
+        finCascade(debut);
+        return;
+    }
+
+    ConvexHull *enveloppe = *listeConvexe;
+
+    // Un point confondu avec un sommet, ou aligné entre les deux sommets d'un segment, n'est pas
+    // un sommet de l'enveloppe : il passe à la couche suivante, comme un point intérieur
+    int evince = -1;
+
+    if (enveloppe->curlen == 1){
+        Point P0 = enveloppe->anneau[enveloppe->pol].p;
+
+        if (P0.x == Q.x && P0.y == Q.y){
+            evince = P;
+        }
+        else{
+            int ins = newCell(enveloppe, Q, P);
+            addBefore(enveloppe, enveloppe->pol, ins);
+
+            enveloppe->curlen += 1;
+            enveloppe->maxlen = 2;
+            enveloppe->modification = moteur->version;
+        }
+    }
+    else if (enveloppe->curlen == 2){
+        int v0 = enveloppe->pol;
+        int v1 = enveloppe->anneau[v0].next;
+        Point P0 = enveloppe->anneau[v0].p;
+        Point P1 = enveloppe->anneau[v1].p;
+        Point P2 = Q;
+        int orientation = orientationTriangle(P0,P1,P2);
+
+        if (orientation == 0){
+            // Segment : seules les deux extrémités restent sommets
+            double avantP0 = (P2.x - P0.x) * (P1.x - P0.x) + (P2.y - P0.y) * (P1.y - P0.y);
+            double apresP1 = (P2.x - P1.x) * (P0.x - P1.x) + (P2.y - P1.y) * (P0.y - P1.y);
+            int remplace = -1;
+
+            if (avantP0 < 0){
+                remplace = v0;
+            }
+            else if (apresP1 < 0){
+                remplace = v1;
+            }
+            else{
+                evince = P;
+            }
+
+            if (remplace >= 0){
+                evince = enveloppe->point[remplace];
+                enveloppe->anneau[remplace].p = Q;
+                enveloppe->point[remplace] = P;
+                enveloppe->modification = moteur->version;
+            }
+        }
+        else{
+            int ins = newCell(enveloppe, Q, P);
+            if(orientation > 0){
+                addAfter(enveloppe, v1, ins);
+            }
+            else{
+                addBefore(enveloppe, v1, ins);
+            }
+
+            enveloppe->curlen += 1;
+            enveloppe->maxlen = 3;
+            enveloppe->modification = moteur->version;
+
+            if (!(moteur->options & MOTEUR_LINEAIRE)){
+                construitIndex(enveloppe, &(moteur->noeuds));
+            }
+        }
+    }
+    else{
+        int insertion = insertionPoint(P, enveloppe, moteur);
+        if (!insertion){
+            evince = P;
+        }
+    }
+
+    if (evince >= 0 && (moteur->options & MOTEUR_COUCHES)){
+        traitementRecursif(evince, &(enveloppe->next), moteur);
+    }
+
+    compteSortieCascade();
+    finCascade(debut);
+}
+
+///////////////////////////////
+// Fonctions index angulaire //
+///////////////////////////////
+
+/*
+ * Les vertex d'une enveloppe sont rangés par angle croissant autour de son point origine,
+ * qui reste strictement intérieur puisqu'une enveloppe ne fait que grandir. L'ordre de l'index
+ * est donc celui du polygone, et le vertex de l'index qui précède un point P donne l'arête
+ * traversée par le segment [origine, P] : P est extérieur si et seulement s'il voit cette arête.
+ */
+
+/**
+ * @brief Renvoie 0 si l'angle de A autour de O est dans [0, pi[, 1 s'il est dans [pi, 2pi[
+ */
+static int demiPlan(Point O, Point A){
+    return (A.y < O.y || (A.y == O.y && A.x < O.x));
+}
+
+/**
+ * @brief Compare les angles de A et B autour de O
+ *
+ * @return Négatif si A précède B, positif si B précède A, 0 si même angle
+ */
+static int compareAngle(Point O, Point A, Point B){
+    int demiA = demiPlan(O, A);
+    int demiB = demiPlan(O, B);
+
+    if (demiA != demiB){
+        return demiA - demiB;
+    }
+
+    return -orientationTriangle(O, A, B);
+}
+
+/**
+ * @brief Générateur xorshift des priorités, propre à chaque enveloppe
+ */
+static unsigned int prioriteSuivante(ConvexHull *enveloppe){
+    unsigned int x = enveloppe->graine;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    enveloppe->graine = x;
+
+    return x;
+}
+
+/**
+ * @brief Sépare l'arbre en deux : les vertex d'angle strictement inférieur à celui de P, et les autres
+ */
+static void coupeIndex(NoeudAngle *arbre, const Vertex *anneau, Point O, Point P,
+                       NoeudAngle **gauche, NoeudAngle **droite){
+    if (!arbre){
+        *gauche = *droite = NULL;
+        return;
+    }
+
+    if (compareAngle(O, anneau[arbre->v].p, P) < 0){
+        coupeIndex(arbre->droite, anneau, O, P, &(arbre->droite), droite);
+        *gauche = arbre;
+    }
+    else{
+        coupeIndex(arbre->gauche, anneau, O, P, gauche, &(arbre->gauche));
+        *droite = arbre;
+    }
+}
+
+/**
+ * @brief Fusionne deux arbres dont tous les angles de gauche précèdent ceux de droite
+ */
+static NoeudAngle *fusionIndex(NoeudAngle *gauche, NoeudAngle *droite){
+    if (!gauche){
+        return droite;
+    }
+    if (!droite){
+        return gauche;
+    }
+
+    if (gauche->priorite > droite->priorite){
+        gauche->droite = fusionIndex(gauche->droite, droite);
+        return gauche;
+    }
+
+    droite->gauche = fusionIndex(gauche, droite->gauche);
+    return droite;
+}
+
+void construitIndex(ConvexHull *enveloppe, Pool *pool){
+    if (enveloppe->curlen < 3){
+        return;
+    }
+
+    const Vertex *anneau = enveloppe->anneau;
+    int v0 = enveloppe->pol;
+    Point A = anneau[v0].p;
+    Point B = anneau[anneau[v0].next].p;
+    Point C = anneau[anneau[anneau[v0].next].next].p;
+
+    if (orientationTriangle(A, B, C) <= 0){
+        return;
+    }
+
+    enveloppe->origine.x = (A.x + B.x + C.x) / 3;
+    enveloppe->origine.y = (A.y + B.y + C.y) / 3;
+
+    int parcours = v0;
+    do{
+        insereIndex(enveloppe, parcours, pool);
+        parcours = anneau[parcours].next;
+    } while (parcours != v0);
+}
+
+int localiseIndex(ConvexHull *enveloppe, Point P){
+    const Vertex *anneau = enveloppe->anneau;
+    NoeudAngle *parcours = enveloppe->index;
+    NoeudAngle *precedent = NULL;
+
+    // Dernier vertex d'angle inférieur ou égal à celui de P
+    while (parcours){
+        if (compareAngle(enveloppe->origine, anneau[parcours->v].p, P) <= 0){
+            precedent = parcours;
+            parcours = parcours->droite;
+        }
+        else{
+            parcours = parcours->gauche;
+        }
+    }
+
+    // Aucun : P précède tous les vertex, son arête est celle qui ferme le tour
+    if (!precedent){
+        for (precedent = enveloppe->index; precedent->droite; precedent = precedent->droite);
+    }
+
+    int a = precedent->v;
+
+    if (orientationTriangle(P, anneau[a].p, anneau[anneau[a].next].p) < 0){
+        return anneau[a].next;
+    }
+
+    return -1;
+}
+
+void insereIndex(ConvexHull *enveloppe, int v, Pool *pool){
+    NoeudAngle *noeud = (NoeudAngle *) allouePool(pool);
+    noeud->v = v;
+    noeud->gauche = noeud->droite = NULL;
+    noeud->priorite = prioriteSuivante(enveloppe);
+
+    NoeudAngle *gauche, *droite;
+    coupeIndex(enveloppe->index, enveloppe->anneau, enveloppe->origine, enveloppe->anneau[v].p, &gauche, &droite);
+    enveloppe->index = fusionIndex(fusionIndex(gauche, noeud), droite);
+}
+
+void supprimeIndex(ConvexHull *enveloppe, int v, Pool *pool){
+    const Vertex *anneau = enveloppe->anneau;
+    NoeudAngle **parcours = &(enveloppe->index);
+    Point P = anneau[v].p;
+
+    while (*parcours && (*parcours)->v != v){
+        if (compareAngle(enveloppe->origine, anneau[(*parcours)->v].p, P) < 0){
+            parcours = &((*parcours)->droite);
+        }
+        else{
+            parcours = &((*parcours)->gauche);
+        }
+    }
+
+    if (*parcours){
+        NoeudAngle *supp = *parcours;
+        *parcours = fusionIndex(supp->gauche, supp->droite);
+        rendPool(pool, supp);
+    }
+}
+
+/////////////////////////
+// Fonctions enveloppe //
+/////////////////////////
+
+void reserveAnneau(ConvexHull *enveloppe, int capacite){
+    if (capacite <= enveloppe->capacite){
+        return;
+    }
+
+    Vertex *anneau = (Vertex *) realloc(enveloppe->anneau, capacite * sizeof(Vertex));
+    if (!anneau){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    enveloppe->anneau = anneau;
+
+    int *point = (int *) realloc(enveloppe->point, capacite * sizeof(int));
+    if (!point){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    enveloppe->point = point;
+
+    enveloppe->capacite = capacite;
+}
+
+int newCell(ConvexHull *enveloppe, Point p, int P){
+    int v = enveloppe->libre;
+
+    if (v >= 0){
+        enveloppe->libre = enveloppe->anneau[v].next;
+    }
+    else{
+        if (enveloppe->nbVertex == enveloppe->capacite){
+            reserveAnneau(enveloppe, enveloppe->capacite ? 2 * enveloppe->capacite : 16);
+        }
+        v = enveloppe->nbVertex++;
+    }
+
+    enveloppe->anneau[v].p = p;
+    enveloppe->anneau[v].prev = enveloppe->anneau[v].next = v;
+    enveloppe->point[v] = P;
+
+    return v;
+}
+
+void rendCell(ConvexHull *enveloppe, int v){
+    enveloppe->anneau[v].next = enveloppe->libre;
+    enveloppe->libre = v;
+}
+
+void addBefore(ConvexHull *enveloppe, int v, int ins){
+    Vertex *anneau = enveloppe->anneau;
+
+    if (v < 0){ // polygone vide
+        enveloppe->pol = ins;
+        return;
+    }
+
+    anneau[ins].next = v;
+    anneau[ins].prev = anneau[v].prev;
+    anneau[anneau[v].prev].next = ins;
+    anneau[v].prev = ins;
+}
+
+void addAfter(ConvexHull *enveloppe, int after, int ins){
+    Vertex *anneau = enveloppe->anneau;
+
+    if (after < 0){ // polygone vide
+        enveloppe->pol = ins;
+        return;
+    }
+
+    anneau[ins].prev = after;
+    anneau[ins].next = anneau[after].next;
+    anneau[anneau[after].next].prev = ins;
+    anneau[after].next = ins;
+}
+
+void printConvex(ConvexHull enveloppe){
+    if (enveloppe.pol >= 0){
+        int v = enveloppe.pol;
+
+        do{
+            printf("x: %f, y: %f\n", enveloppe.anneau[v].p.x, enveloppe.anneau[v].p.y);
+            v = enveloppe.anneau[v].next;
+        } while (v != enveloppe.pol);
+
+        printf("\n");
+    }
+}
+
+void printConvexAdresse(const ConvexHull *enveloppe){
+    if (enveloppe->pol >= 0){
+        int v = enveloppe->pol;
+
+        do{
+            const Vertex *vertex = &(enveloppe->anneau[v]);
+            printf("x: %f, y: %f, INDICE P: %d, VERTEX: %d,  PREV: %d, NEXT: %d\n", vertex->p.x, vertex->p.y, enveloppe->point[v], v, vertex->prev, vertex->next);
+            v = vertex->next;
+        } while (v != enveloppe->pol);
+
+        printf("\n");
+    }
+}
+
+///////////////////////////////
+// Fonctions nuage de points //
+///////////////////////////////
+
+void initNuage(NuagePoints *nuage, int capacite){
+    nuage->x = NULL;
+    nuage->y = NULL;
+    nuage->nbPoint = 0;
+    nuage->capacite = 0;
+
+    if (capacite > 0){
+        nuage->x = (double *) malloc(capacite * sizeof(double));
+        nuage->y = (double *) malloc(capacite * sizeof(double));
+        if (!nuage->x || !nuage->y){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        nuage->capacite = capacite;
+    }
+}
+
+int ajoutePoint(NuagePoints *nuage, Point p){
+    if (nuage->nbPoint == nuage->capacite){
+        int capacite = nuage->capacite ? 2 * nuage->capacite : 256;
+        double *x = (double *) realloc(nuage->x, capacite * sizeof(double));
+        double *y = (double *) realloc(nuage->y, capacite * sizeof(double));
+        if (!x || !y){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        nuage->x = x;
+        nuage->y = y;
+        nuage->capacite = capacite;
+    }
+
+    nuage->x[nuage->nbPoint] = p.x;
+    nuage->y[nuage->nbPoint] = p.y;
+
+    return nuage->nbPoint++;
+}
+
+void printNuage(const NuagePoints *nuage){
+    for (int i = 0; i < nuage->nbPoint; i++){
+        printf("x: %f, y: %f, indice: %d\n", nuage->x[i], nuage->y[i], i);
+    }
+}
+
+void libereNuage(NuagePoints *nuage){
+    free(nuage->x);
+    free(nuage->y);
+    initNuage(nuage, 0);
+}
+
+/////////////////////////////
+// Fonctions liste convexe //
+/////////////////////////////
+
+ListeConvexe alloueCelluleConvexe(void){
+    ConvexHull *newHull;
+
+    newHull = (ConvexHull *) malloc(sizeof(ConvexHull));
+
+    if (newHull){
+        newHull->pol = -1;
+        newHull->anneau = NULL;
+        newHull->point = NULL;
+        newHull->capacite = 0;
+        newHull->nbVertex = 0;
+        newHull->libre = -1;
+        newHull->next = NULL;
+        newHull->curlen = 0;
+        newHull->maxlen = 0;
+        newHull->numero = 0;
+        newHull->index = NULL;
+        newHull->graine = 2463534242u;
+        newHull->modification = 0;
+    }
+
+    return newHull;
+}
+
+void insereQueueConvexe(ListeConvexe *liste){
+    ConvexHull *newHull = alloueCelluleConvexe();
+    ListeConvexe parcours = *liste;
+
+    if (newHull){
+        if(*liste == NULL){
+            *liste = newHull;
+        }
+        else{
+            for(; parcours->next; parcours = parcours->next);
+
+            parcours->next = newHull ;
+        }
+    }
+}
+
+void printListeConvexe(ListeConvexe listeConvexe){
+    int i = 0;
+    for (; listeConvexe; listeConvexe = listeConvexe->next){
+        printf("CONV %d, adresse: %p\n", i, (void *) listeConvexe);
+        printConvexAdresse(listeConvexe);
+        i += 1;
+    }
+}
+
+void freeListeConvexe(ListeConvexe *listeConvexe){
+    ListeConvexe c;
+    ListeConvexe tmp_c = *listeConvexe;
+
+    while(tmp_c){
+        c = tmp_c;
+        tmp_c = tmp_c->next;
+        free(c->anneau);
+        free(c->point);
+        free(c);
+    }
+    (*listeConvexe) = NULL;
+}
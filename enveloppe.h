@@ -0,0 +1,369 @@
+#ifndef ENVELOPPE_H
+#define ENVELOPPE_H
+
+#include <math.h>
+#include <float.h>
+
+#include "pool.h"
+#include "compteurs.h"
+#include "latence.h"
+
+/*
+ * Moteur de calcul des enveloppes convexes, sans aucune dépendance à MLV.
+ * Les programmes graphiques env_convexes_p1.c et env_convexes_p2.c ne sont
+ * que des clients de ce moteur.
+ */
+
+typedef struct s_point{
+    double x;
+    double y;
+} Point;
+
+/**
+ * @brief Ensemble des points rangé en tableaux séparés des abscisses et des ordonnées, qui
+ * grandissent par doublement. Un point est désigné par son indice, qui ne change jamais
+ *
+ */
+typedef struct{
+    double *x; /* les abscisses */
+    double *y; /* les ordonnées */
+    int nbPoint; /* nombre de points rangés */
+    int capacite; /* taille allouée des tableaux */
+} NuagePoints;
+
+/**
+ * @brief Vertex d'un anneau doublement chaîné circulaire, rangé dans le tableau de son enveloppe.
+ * Les coordonnées sont recopiées du nuage pour que le parcours du polygone ne lise que l'anneau,
+ * et les voisins sont désignés par leur indice dans ce tableau
+ *
+ */
+typedef struct{
+    Point p; /* les coordonnées du point */
+    int prev; /* l'indice du vertex précédent */
+    int next; /* l'indice du vertex suivant */
+} Vertex;
+
+/**
+ * @brief Noeud d'un arbre binaire de recherche équilibré (tas-arbre) indexant les vertex d'une
+ * enveloppe par angle autour d'un point intérieur
+ *
+ */
+typedef struct s_noeud_angle{
+    int v; /* l'indice du vertex indexé */
+    struct s_noeud_angle *gauche; /* les vertex d'angle inférieur */
+    struct s_noeud_angle *droite; /* les vertex d'angle supérieur */
+    unsigned int priorite; /* priorité aléatoire du tas */
+} NoeudAngle;
+
+/**
+ * @brief Structure liste chaînée de l'enveloppe convexe contenant un Polygone (un anneau de vertex)
+ * et sa taille actuelle et maximale, ainsi que son enveloppe prochaine
+ *
+ */
+typedef struct s_convex{
+    int pol; /* le premier vertex du polygône (-1 si vide) */
+    Vertex *anneau; /* tous les vertex, utilisés ou libres */
+    int *point; /* l'indice dans le nuage du point de chaque vertex */
+    int capacite; /* taille allouée de l'anneau */
+    int nbVertex; /* nombre de vertex déjà servis de l'anneau */
+    int libre; /* premier vertex rendu, chaîné par next (-1 si aucun) */
+    struct s_convex *next; /* l'enveloppe suivante (couche intérieure) */
+    int curlen; /* la longueur courante */
+    int maxlen; /* la longueur maximale */
+    int numero; /* le rang de l'enveloppe, utilisé par l'affichage pour la couleur */
+    Point origine; /* point strictement intérieur, centre de l'index angulaire */
+    NoeudAngle *index; /* index angulaire des vertex (NULL si parcours linéaire) */
+    unsigned int graine; /* état du générateur des priorités de l'index */
+    unsigned long modification; /* version du moteur lors de la dernière modification de l'anneau */
+} ConvexHull, *ListeConvexe;
+
+/* Options de création du moteur */
+#define MOTEUR_ENVELOPPE 0 /* une seule enveloppe, les points évincés sont perdus */
+#define MOTEUR_COUCHES   1 /* couches convexes, les points évincés passent à la couche suivante */
+#define MOTEUR_LINEAIRE  2 /* localisation par parcours de tout le polygone au lieu de l'index angulaire */
+#define MOTEUR_PREFILTRE 4 /* construitMoteur écarte d'abord les points intérieurs à l'octogone d'Akl-Toussaint */
+#define MOTEUR_QUICKHULL 8 /* construitMoteur calcule l'enveloppe par QuickHull à vol de tâches */
+#define MOTEUR_CHAN      16 /* construitMoteur calcule l'enveloppe par l'algorithme de Chan */
+#define MOTEUR_GRILLE    32 /* construitMoteur calcule l'enveloppe par colonnes si les abscisses sont entières et bornées */
+
+/**
+ * @brief Moteur de calcul : la liste des enveloppes et son mode de fonctionnement
+ *
+ */
+typedef struct{
+    const NuagePoints *nuage; /* les points, auxquels renvoient les vertex */
+    ListeConvexe listeConvexe; /* la première enveloppe (couche extérieure) */
+    int options; /* combinaison des options MOTEUR_* */
+    int nbConvexe; /* nombre d'enveloppes créées */
+    int nbPrefiltre; /* points écartés par le préfiltre ou la grille lors du dernier construitMoteur */
+    int nbThread; /* threads de construitMoteur (1 par défaut, 0: un par processeur) */
+    int largeurGrille; /* colonnes de la grille de MOTEUR_GRILLE (abscisses de 0 à largeurGrille - 1) */
+    unsigned long version; /* augmentée à chaque insertion ou construction, date des modifications des couches */
+    Pool noeuds; /* les noeuds des index angulaires */
+} Moteur;
+
+//////////////////////
+// Fonctions moteur //
+//////////////////////
+
+/**
+ * @brief Crée un moteur vide travaillant sur les points d'un nuage. Le nuage n'est pas copié :
+ * il doit rester valide tant que le moteur existe, et peut grandir entre deux insertions
+ *
+ * @param options MOTEUR_ENVELOPPE ou MOTEUR_COUCHES, éventuellement combiné avec MOTEUR_LINEAIRE,
+ * MOTEUR_PREFILTRE, MOTEUR_GRILLE et MOTEUR_QUICKHULL ou MOTEUR_CHAN
+ * @param nuage Le nuage des points
+ * @return Le moteur alloué, NULL si plus de mémoire
+ */
+Moteur *creeMoteur(int options, const NuagePoints *nuage);
+
+/**
+ * @brief Dimensionne les blocs des noeuds d'index du moteur d'après le nombre de points attendus
+ * (en mode couches, chaque point finit sommet d'une couche)
+ *
+ * @param moteur Le moteur
+ * @param nbPoint Nombre de points attendus
+ */
+void reserveMoteur(Moteur *moteur, int nbPoint);
+
+/**
+ * @brief Insère un point du nuage dans le moteur
+ *
+ * @param moteur Le moteur
+ * @param P L'indice du point dans le nuage
+ * @return 1 si l'enveloppe extérieure a été modifiée, 0 sinon
+ */
+int insereMoteur(Moteur *moteur, int P);
+
+/**
+ * @brief Renvoie la liste des enveloppes du moteur, de l'extérieure vers l'intérieure
+ *
+ * @param moteur Le moteur
+ * @return La liste des enveloppes (NULL si aucun point)
+ */
+ListeConvexe enveloppesMoteur(const Moteur *moteur);
+
+/**
+ * @brief Libère le moteur, toutes ses enveloppes et tous leurs polygones (les points ne sont pas
+ * libérés)
+ *
+ * @param moteur Le moteur
+ */
+void detruitMoteur(Moteur *moteur);
+
+/////////////////////////
+// Fonctions de calcul //
+/////////////////////////
+
+/* Borne d'erreur relative du déterminant calculé en double : (3 + 16 eps) eps, avec eps = 2^-53 */
+#define ERREUR_ORIENTATION ((3.0 + 8.0 * DBL_EPSILON) * DBL_EPSILON / 2)
+
+/**
+ * @brief Renvoie le signe exact de l'orientation d'un triangle, calculé en arithmétique exacte.
+ * Utilisée par orientationTriangle quand le calcul en double ne suffit pas
+ */
+int orientationExacte(Point A, Point B, Point C);
+
+/**
+ * @brief Renvoie l'orientation d'un triangle. Le signe est exact : le déterminant est calculé en
+ * double avec une borne de son erreur d'arrondi (filtre de Shewchuk), et n'est refait en
+ * arithmétique exacte que si le signe n'est pas garanti, pour des points (presque) alignés
+ *
+ * @param Sommet A du triangle
+ * @param Sommet B du triangle
+ * @param Sommet C du triangle
+ * @return 1 si l'orientation est directe, -1 si elle est indirecte, 0 si les points sont alignés
+ */
+static inline int orientationTriangle(Point A, Point B, Point C){
+    COMPTE(orientations);
+
+    double gauche = (A.x - C.x) * (B.y - C.y);
+    double droite = (A.y - C.y) * (B.x - C.x);
+    double det = gauche - droite;
+    double borne = ERREUR_ORIENTATION * (fabs(gauche) + fabs(droite));
+
+    if (det > borne){
+        return 1;
+    }
+    if (det < -borne){
+        return -1;
+    }
+    // Deux produits nuls sont exacts : les points sont alignés
+    if (borne == 0){
+        return 0;
+    }
+
+    COMPTE(exactes);
+    return orientationExacte(A, B, C);
+}
+
+int appartientCercle(Point P, Point centre, int R);
+int appartientCarre(Point P, Point centre, int R);
+
+/**
+ * @brief Genere un point aléatoirement et qui fait partie de la fenêtre, avec rand() et par rejet.
+ * Les tirages de aleatoire.h suivent la même loi, sans rejet et avec une graine
+ *
+ * @param forme 1: Génération aléatoire en forme de cercle 2: Génération aléatoire en forme de carré
+ * @param R Rayon du cercle/carré
+ * @param centre Centre du cercle/carré
+ * @return Point
+ */
+Point getPoint(int forme, int R, Point centre);
+
+/**
+ * @brief Calcule l'orientation et insère un point dans l'enveloppe à sa place
+ *
+ * @param P L'indice du point à vérifier dans le nuage
+ * @param enveloppe L'adresse de l'enveloppe convexe
+ * @param moteur Le moteur (pour le traitement des points évincés)
+ * @return 0 si pas d'insertion (orientation directe), 1 sinon
+ */
+int insertionPoint(int P, ConvexHull *enveloppe, Moteur *moteur);
+
+/**
+ * @brief Effectue le nettoyage avant de l'enveloppe après insertion, et supprime les vertex qu'il
+ * faut supprimer
+ *
+ * @param v Le vertex inséré
+ * @param enveloppe Adresse de l'enveloppe
+ * @param moteur Le moteur (pour le traitement des points évincés)
+ */
+void nettoyageAvant2(int v, ConvexHull *enveloppe, Moteur *moteur);
+
+/**
+ * @brief Effectue le nettoyage après de l'enveloppe après insertion, et supprime les vertex qu'il
+ * faut supprimer
+ *
+ * @param v Le vertex inséré
+ * @param enveloppe Adresse de l'enveloppe
+ * @param moteur Le moteur (pour le traitement des points évincés)
+ */
+void nettoyageArriere2(int v, ConvexHull *enveloppe, Moteur *moteur);
+
+/**
+ * @brief Fonction qui vérifie si un point est à l'exterieur où à l'interieur d'une enveloppe
+ * et appele récursivement avec toute la liste des enveloppes (en mode MOTEUR_COUCHES)
+ *
+ * @param P Indice du point à traiter
+ * @param listeConvexe La liste des enveloppes
+ * @param moteur Le moteur
+ */
+void traitementRecursif(int P, ListeConvexe *listeConvexe, Moteur *moteur);
+
+///////////////////////////////
+// Fonctions index angulaire //
+///////////////////////////////
+
+/**
+ * @brief Construit l'index angulaire d'une enveloppe d'au moins 3 vertex, autour du centre de
+ * ses 3 premiers vertex. L'index n'est pas construit si ce triangle est dégénéré : l'enveloppe
+ * reste alors en parcours linéaire
+ *
+ * @param enveloppe L'adresse de l'enveloppe
+ * @param pool Le pool des noeuds d'index
+ */
+void construitIndex(ConvexHull *enveloppe, Pool *pool);
+
+/**
+ * @brief Localise un point par recherche dichotomique dans l'index angulaire, en O(log h)
+ *
+ * @param enveloppe L'adresse de l'enveloppe indexée
+ * @param P Le point à localiser
+ * @return Le vertex devant lequel insérer P s'il est visible, -1 si P est intérieur
+ */
+int localiseIndex(ConvexHull *enveloppe, Point P);
+
+void insereIndex(ConvexHull *enveloppe, int v, Pool *pool);
+void supprimeIndex(ConvexHull *enveloppe, int v, Pool *pool);
+
+/////////////////////////
+// Fonctions enveloppe //
+/////////////////////////
+
+/**
+ * @brief Agrandit l'anneau de l'enveloppe pour qu'il puisse contenir au moins capacite vertex.
+ * Les indices des vertex ne changent pas, mais leurs adresses peuvent changer
+ *
+ * @param enveloppe L'adresse de l'enveloppe
+ * @param capacite Nombre de vertex voulus
+ */
+void reserveAnneau(ConvexHull *enveloppe, int capacite);
+
+/**
+ * @brief Renvoie un vertex isolé (son propre voisin) de l'anneau, recyclé si possible
+ *
+ * @param enveloppe L'adresse de l'enveloppe
+ * @param p Les coordonnées du point
+ * @param P L'indice du point dans le nuage
+ * @return L'indice du vertex
+ */
+int newCell(ConvexHull *enveloppe, Point p, int P);
+
+/**
+ * @brief Rend un vertex déjà détaché du polygone à l'anneau, qui le recyclera
+ */
+void rendCell(ConvexHull *enveloppe, int v);
+
+void addBefore(ConvexHull *enveloppe, int v, int ins);
+void addAfter(ConvexHull *enveloppe, int after, int ins);
+void printConvex(ConvexHull enveloppe);
+void printConvexAdresse(const ConvexHull *enveloppe);
+
+///////////////////////////////
+// Fonctions nuage de points //
+///////////////////////////////
+
+/**
+ * @brief Initialise un nuage vide
+ *
+ * @param nuage Adresse du nuage
+ * @param capacite Nombre de points attendus (0 si inconnu)
+ */
+void initNuage(NuagePoints *nuage, int capacite);
+
+/**
+ * @brief Ajoute un point à la fin du nuage. Arrête le programme si plus de mémoire
+ *
+ * @param nuage Adresse du nuage
+ * @param p Le point
+ * @return L'indice du point ajouté
+ */
+int ajoutePoint(NuagePoints *nuage, Point p);
+
+/**
+ * @brief Renvoie le point d'indice i du nuage
+ */
+static inline Point pointNuage(const NuagePoints *nuage, int i){
+    Point P;
+    P.x = nuage->x[i];
+    P.y = nuage->y[i];
+    return P;
+}
+
+void printNuage(const NuagePoints *nuage);
+
+/**
+ * @brief Libère les tableaux du nuage, qui redevient vide
+ *
+ * @param nuage Adresse du nuage
+ */
+void libereNuage(NuagePoints *nuage);
+
+/////////////////////////////
+// Fonctions liste convexe //
+/////////////////////////////
+
+ListeConvexe alloueCelluleConvexe(void);
+void insereQueueConvexe(ListeConvexe *liste);
+void printListeConvexe(ListeConvexe ListeConvexe);
+
+/**
+ * @brief Libère toutes les enveloppes convexes et leurs anneaux. Les noeuds d'index appartiennent
+ * au pool du moteur et sont libérés avec lui
+ *
+ * @param listeConvexe Adresse de la liste chaînée des enveloppes
+ */
+void freeListeConvexe(ListeConvexe *listeConvexe);
+
+#endif
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "enveloppe.h"
+#include "statique.h"
+#include "fichier.h"
+#include "flux.h"
+#include "sortie.h"
+
+#define GRILLE_MAX (1 << 20) /* largeur maximale de la grille choisie d'après la boîte englobante */
+
+/*
+ * Calcul statique sur un fichier binaire de points (fichier.h), projeté en mémoire : le calcul
+ * commence sans lecture ni copie des points. L'enveloppe, ou les couches avec "couches", est
+ * écrite sur la sortie standard en texte, en JSON avec -j, ou dans un fichier binaire avec -b
+ * (sortie.h).
+ *
+ * Utilisation : enveloppe_fichier points.pts [couches] [-j | -b sortie.bin]
+ *               enveloppe_fichier -c points.txt points.pts [type (1: double; 2: float; 3: int32)]
+ */
+
+/**
+ * @brief Renvoie le temps écoulé en secondes depuis une origine arbitraire
+ */
+static double chrono(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Convertit un fichier texte (un point "x y" par ligne) en fichier de points
+ */
+static int convertit(const char *texte, const char *binaire, int type){
+    FILE *entree = (strcmp(texte, "-") == 0) ? stdin : fopen(texte, "r");
+    if (!entree){
+        fprintf(stderr, "Impossible d'ouvrir %s\n", texte);
+        return 1;
+    }
+
+    NuagePoints nuage;
+    initNuage(&nuage, 0);
+    long nbInvalide = 0;
+    while (lisPoints(entree, &nuage, FLUX_LOT, &nbInvalide) > 0){}
+    if (entree != stdin){
+        fclose(entree);
+    }
+
+    int ok = ecritFichierPoints(binaire, &nuage, type);
+    fprintf(stderr, "%d points ecrits, %ld lignes illisibles\n", ok ? nuage.nbPoint : 0, nbInvalide);
+    libereNuage(&nuage);
+
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char *argv[]){
+    if (argc > 3 && strcmp(argv[1], "-c") == 0){
+        return convertit(argv[2], argv[3], (argc > 4) ? atoi(argv[4]) : COORD_DOUBLE);
+    }
+    if (argc < 2){
+        fprintf(stderr, "Utilisation : %s points.pts [couches] [-j | -b sortie.bin]\n", argv[0]);
+        return 1;
+    }
+
+    int couches = 0;
+    int json = 0;
+    const char *binaire = NULL;
+    for (int i = 2; i < argc; i++){
+        if (strcmp(argv[i], "couches") == 0){
+            couches = 1;
+        }
+        else if (strcmp(argv[i], "-j") == 0){
+            json = 1;
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc){
+            binaire = argv[++i];
+        }
+    }
+
+    double debut = chrono();
+    FichierPoints fichier;
+    if (!ouvreFichierPoints(argv[1], &fichier)){
+        return 1;
+    }
+    double tOuverture = chrono() - debut;
+
+    const EnTetePoints *entete = &(fichier.entete);
+    int options = couches ? MOTEUR_COUCHES : (MOTEUR_ENVELOPPE | MOTEUR_PREFILTRE);
+
+    Moteur *moteur = creeMoteur(options, &(fichier.nuage));
+    if (!moteur){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    moteur->nbThread = 0;
+
+    // Des coordonnées entières positives et bornées permettent le calcul par colonnes
+    if (entete->type == COORD_INT32 && entete->boite && entete->xmin >= 0 && entete->xmax < GRILLE_MAX){
+        moteur->options |= MOTEUR_GRILLE;
+        moteur->largeurGrille = (int) entete->xmax + 1;
+    }
+
+    debut = chrono();
+    construitMoteur(moteur);
+    double tCalcul = chrono() - debut;
+
+    int nbSommet = enveloppesMoteur(moteur) ? enveloppesMoteur(moteur)->curlen : 0;
+    fprintf(stderr, "%d points, ouverture %.3f s, calcul %.3f s, %d %s\n", fichier.nuage.nbPoint, tOuverture,
+            tCalcul, couches ? moteur->nbConvexe : nbSommet, couches ? "couches" : "sommets");
+
+    int ok = 1;
+    if (binaire){
+        FILE *sortie = fopen(binaire, "wb");
+        ok = sortie && ecritCouchesBinaires(sortie, enveloppesMoteur(moteur));
+        ok = sortie && (fclose(sortie) == 0) && ok;
+    }
+    else if (couches || json){
+        ok = ecritCouchesTexte(stdout, enveloppesMoteur(moteur), json);
+    }
+    else{
+        ecritEnveloppe(stdout, enveloppesMoteur(moteur));
+    }
+    if (!ok){
+        fprintf(stderr, "Erreur d'ecriture\n");
+    }
+
+    detruitMoteur(moteur);
+    fermeFichierPoints(&fichier);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,186 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "enveloppe.h"
+#include "statique.h"
+#include "fichier.h"
+#include "flux.h"
+#include "raster.h"
+
+#define IMAGE_LARGEUR 800 /* dimensions par défaut de l'image, celles de la fenêtre */
+#define IMAGE_HAUTEUR 800
+#define IMAGE_MARGE 10 /* marge autour des points qui ne tiennent pas dans l'image */
+
+/*
+ * Image de l'enveloppe, ou des couches avec "couches", d'un fichier de points, sans fenêtre : le
+ * dessin d'env_convexes_p1 (ou celui du mode aléatoire d'env_convexes_p2) est fait en mémoire par
+ * raster.h puis écrit en PNG si le nom de l'image finit par ".png", en PPM sinon. Les points sont
+ * lus dans un fichier binaire (fichier.h) ou texte, un point "x y" par ligne (-: entrée
+ * standard). Des points qui tiennent dans l'image, comme ceux des interfaces, gardent leurs
+ * coordonnées ; les autres sont mis à l'échelle de l'image. Au-delà de DENSITE_SEUIL points, ils
+ * sont dessinés en carte de densité.
+ *
+ * Utilisation : enveloppe_image points image.png [couches] [-t largeur hauteur] [-j threads]
+ */
+
+/**
+ * @brief Renvoie le temps écoulé en secondes depuis une origine arbitraire
+ */
+static double chrono(){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Renvoie 1 si le fichier commence par la signature des fichiers binaires de points
+ */
+static int estFichierPoints(const char *chemin){
+    char magie[sizeof(FICHIER_MAGIE)];
+    FILE *entree = fopen(chemin, "rb");
+    if (!entree){
+        return 0;
+    }
+
+    int ok = fread(magie, 1, sizeof(magie), entree) == sizeof(magie);
+    ok = ok && memcmp(magie, FICHIER_MAGIE, sizeof(magie)) == 0;
+    fclose(entree);
+
+    return ok;
+}
+
+/**
+ * @brief Lit un fichier texte de points (un point "x y" par ligne, -: entrée standard)
+ */
+static int lisTexte(const char *chemin, NuagePoints *nuage){
+    FILE *entree = (strcmp(chemin, "-") == 0) ? stdin : fopen(chemin, "r");
+    if (!entree){
+        fprintf(stderr, "Impossible d'ouvrir %s\n", chemin);
+        return 0;
+    }
+
+    long nbInvalide = 0;
+    while (lisPoints(entree, nuage, FLUX_LOT, &nbInvalide) > 0){}
+    if (entree != stdin){
+        fclose(entree);
+    }
+    if (nbInvalide){
+        fprintf(stderr, "%ld lignes illisibles\n", nbInvalide);
+    }
+
+    return 1;
+}
+
+int main(int argc, char *argv[]){
+    if (argc < 3){
+        fprintf(stderr, "Utilisation : %s points image.png [couches] [-t largeur hauteur] [-j threads]\n", argv[0]);
+        return 1;
+    }
+
+    int couches = 0;
+    int largeur = IMAGE_LARGEUR;
+    int hauteur = IMAGE_HAUTEUR;
+    int nbThread = 0;
+    for (int i = 3; i < argc; i++){
+        if (strcmp(argv[i], "couches") == 0){
+            couches = 1;
+        }
+        else if (strcmp(argv[i], "-t") == 0 && i + 2 < argc){
+            largeur = atoi(argv[++i]);
+            hauteur = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc){
+            nbThread = atoi(argv[++i]);
+        }
+    }
+    if (largeur <= 0 || hauteur <= 0){
+        fprintf(stderr, "Dimensions invalides : %d x %d\n", largeur, hauteur);
+        return 1;
+    }
+
+    // Un fichier binaire est projeté en mémoire, un fichier texte lu dans un nuage
+    FichierPoints fichier;
+    NuagePoints texte;
+    const NuagePoints *nuage;
+    int binaire = strcmp(argv[1], "-") != 0 && estFichierPoints(argv[1]);
+    initNuage(&texte, 0);
+    if (binaire){
+        if (!ouvreFichierPoints(argv[1], &fichier)){
+            return 1;
+        }
+        nuage = &(fichier.nuage);
+    }
+    else{
+        if (!lisTexte(argv[1], &texte)){
+            return 1;
+        }
+        nuage = &texte;
+    }
+
+    Moteur *moteur = creeMoteur(couches ? MOTEUR_COUCHES : (MOTEUR_ENVELOPPE | MOTEUR_PREFILTRE), nuage);
+    if (!moteur){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    moteur->nbThread = nbThread;
+
+    double debut = chrono();
+    construitMoteur(moteur);
+    double tCalcul = chrono() - debut;
+
+    Scene scene;
+    initScene(&scene);
+    scene.couches = enveloppesMoteur(moteur);
+    if (couches){
+        // Le mode aléatoire d'env_convexes_p2 : couches colorées, sans points ni sommets
+        scene.couleurs = couleursCouches;
+        scene.nbCouleur = nbCouleursCouches;
+        scene.rayonSommet = 0;
+        scene.sommetsMin = 3;
+    }
+    else{
+        // Au-delà de DENSITE_SEUIL points, les disques se recouvrent : les points sont comptés
+        // par pixel et le dessin ne dépend plus que de la surface de l'image
+        scene.nuage = nuage;
+        scene.densite = nuage->nbPoint > DENSITE_SEUIL;
+    }
+
+    if (nuage->nbPoint > 0){
+        double xmin = nuage->x[0], xmax = xmin;
+        double ymin = nuage->y[0], ymax = ymin;
+        for (int i = 1; i < nuage->nbPoint; i++){
+            xmin = (nuage->x[i] < xmin) ? nuage->x[i] : xmin;
+            xmax = (nuage->x[i] > xmax) ? nuage->x[i] : xmax;
+            ymin = (nuage->y[i] < ymin) ? nuage->y[i] : ymin;
+            ymax = (nuage->y[i] > ymax) ? nuage->y[i] : ymax;
+        }
+        if (xmin < 0 || ymin < 0 || xmax > largeur - 1 || ymax > hauteur - 1){
+            cadreScene(&scene, xmin, ymin, xmax, ymax, largeur, hauteur, IMAGE_MARGE);
+        }
+    }
+
+    Image image;
+    creeImage(&image, largeur, hauteur);
+    debut = chrono();
+    rasteriseScene(&image, &scene, nbThread);
+    double tDessin = chrono() - debut;
+
+    debut = chrono();
+    int ok = ecritImage(&image, argv[2]);
+    double tEcriture = chrono() - debut;
+
+    fprintf(stderr, "%d points, calcul %.3f s, dessin %.3f s, ecriture %.3f s, %d %s\n", nuage->nbPoint, tCalcul,
+            tDessin, tEcriture, couches ? moteur->nbConvexe : (scene.couches ? scene.couches->curlen : 0),
+            couches ? "couches" : "sommets");
+
+    libereImage(&image);
+    detruitMoteur(moteur);
+    if (binaire){
+        fermeFichierPoints(&fichier);
+    }
+    libereNuage(&texte);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "fichier.h"
+
+#define TAMPON_CONVERSION 4096 /* nombre de coordonnées converties d'un coup à l'écriture */
+
+_Static_assert(sizeof(EnTetePoints) == 64, "l'en-tête d'un fichier de points fait 64 octets");
+
+/**
+ * @brief Renvoie la taille d'une coordonnée du type donné, 0 si le type est inconnu
+ */
+static size_t tailleCoordonnee(uint32_t type){
+    switch (type){
+        case COORD_DOUBLE: return sizeof(double);
+        case COORD_FLOAT: return sizeof(float);
+        case COORD_INT32: return sizeof(int32_t);
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Convertit en doubles n coordonnées du type donné
+ *
+ * @return 1 si toutes les coordonnées sont finies, 0 sinon
+ */
+static int convertitCoordonnees(const void *source, uint32_t type, double *destination, int n){
+    int finies = 1;
+    if (type == COORD_FLOAT){
+        const float *f = (const float *) source;
+        for (int i = 0; i < n; i++){
+            destination[i] = f[i];
+            finies &= isfinite(f[i]) != 0;
+        }
+    }
+    else{
+        const int32_t *e = (const int32_t *) source;
+        for (int i = 0; i < n; i++){
+            destination[i] = e[i];
+        }
+    }
+    return finies;
+}
+
+/**
+ * @brief Renvoie 1 si les n coordonnées sont finies, 0 sinon
+ */
+static int coordonneesFinies(const double *v, int n){
+    int finies = 1;
+    for (int i = 0; i < n; i++){
+        finies &= isfinite(v[i]) != 0;
+    }
+    return finies;
+}
+
+int ouvreFichierPoints(const char *chemin, FichierPoints *fichier){
+    int fd = open(chemin, O_RDONLY);
+    if (fd < 0){
+        fprintf(stderr, "Impossible d'ouvrir %s\n", chemin);
+        return 0;
+    }
+
+    struct stat etat;
+    if (fstat(fd, &etat) < 0 || (size_t) etat.st_size < sizeof(EnTetePoints)){
+        fprintf(stderr, "%s n'est pas un fichier de points\n", chemin);
+        close(fd);
+        return 0;
+    }
+
+    size_t taille = (size_t) etat.st_size;
+    void *projection = mmap(NULL, taille, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (projection == MAP_FAILED){
+        fprintf(stderr, "Impossible de projeter %s en memoire\n", chemin);
+        return 0;
+    }
+
+    memcpy(&(fichier->entete), projection, sizeof(EnTetePoints));
+    const EnTetePoints *entete = &(fichier->entete);
+    size_t tailleCoord = tailleCoordonnee(entete->type);
+
+    if (memcmp(entete->magie, FICHIER_MAGIE, sizeof(entete->magie)) != 0 || tailleCoord == 0
+        || entete->nbPoint > INT_MAX
+        || (taille - sizeof(EnTetePoints)) / (2 * tailleCoord) < entete->nbPoint){
+        fprintf(stderr, "%s n'est pas un fichier de points valide\n", chemin);
+        munmap(projection, taille);
+        return 0;
+    }
+
+    int nbPoint = (int) entete->nbPoint;
+    const char *donnees = (const char *) projection + sizeof(EnTetePoints);
+
+    if (entete->type == COORD_DOUBLE){
+        // Les tableaux du nuage sont ceux du fichier (l'en-tête garde les doubles alignés)
+        madvise(projection, taille, MADV_SEQUENTIAL);
+        fichier->nuage.x = (double *) donnees;
+        fichier->nuage.y = (double *) donnees + nbPoint;
+        fichier->nuage.nbPoint = nbPoint;
+        fichier->nuage.capacite = nbPoint;
+        fichier->projection = projection;
+        fichier->taille = taille;
+
+        // Les doubles ne sont pas copiés, mais ils sont lus une fois pour refuser les non finis
+        if (!coordonneesFinies(fichier->nuage.x, nbPoint) || !coordonneesFinies(fichier->nuage.y, nbPoint)){
+            fprintf(stderr, "%s contient des coordonnees non finies\n", chemin);
+            fermeFichierPoints(fichier);
+            return 0;
+        }
+    }
+    else{
+        initNuage(&(fichier->nuage), nbPoint);
+        int finies = convertitCoordonnees(donnees, entete->type, fichier->nuage.x, nbPoint);
+        finies &= convertitCoordonnees(donnees + nbPoint * tailleCoord, entete->type, fichier->nuage.y, nbPoint);
+        fichier->nuage.nbPoint = nbPoint;
+        fichier->projection = NULL;
+        fichier->taille = 0;
+        munmap(projection, taille);
+
+        if (!finies){
+            fprintf(stderr, "%s contient des coordonnees non finies\n", chemin);
+            libereNuage(&(fichier->nuage));
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+void fermeFichierPoints(FichierPoints *fichier){
+    if (fichier->projection){
+        munmap(fichier->projection, fichier->taille);
+        fichier->projection = NULL;
+        initNuage(&(fichier->nuage), 0);
+    }
+    else{
+        libereNuage(&(fichier->nuage));
+    }
+}
+
+/**
+ * @brief Renvoie la valeur relue d'une coordonnée écrite avec le type donné
+ */
+static double valeurEcrite(double v, uint32_t type){
+    if (type == COORD_FLOAT){
+        return (float) v;
+    }
+    if (type == COORD_INT32){
+        return (double) lround(v);
+    }
+    return v;
+}
+
+/**
+ * @brief Écrit n coordonnées converties dans le type donné
+ *
+ * @return 1 si tout a été écrit
+ */
+static int ecritCoordonnees(FILE *f, const double *v, int n, uint32_t type){
+    if (type == COORD_DOUBLE){
+        return fwrite(v, sizeof(double), n, f) == (size_t) n;
+    }
+
+    union{
+        float f[TAMPON_CONVERSION];
+        int32_t e[TAMPON_CONVERSION];
+    } tampon;
+
+    for (int debut = 0; debut < n; debut += TAMPON_CONVERSION){
+        int nb = (n - debut < TAMPON_CONVERSION) ? n - debut : TAMPON_CONVERSION;
+        for (int i = 0; i < nb; i++){
+            if (type == COORD_FLOAT){
+                tampon.f[i] = (float) v[debut + i];
+            }
+            else{
+                tampon.e[i] = (int32_t) lround(v[debut + i]);
+            }
+        }
+        if (fwrite(&tampon, tailleCoordonnee(type), nb, f) != (size_t) nb){
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+int ecritFichierPoints(const char *chemin, const NuagePoints *nuage, int type){
+    EnTetePoints entete;
+    memset(&entete, 0, sizeof entete);
+    memcpy(entete.magie, FICHIER_MAGIE, sizeof(entete.magie));
+    entete.type = (uint32_t) type;
+    entete.nbPoint = (uint64_t) nuage->nbPoint;
+
+    if (tailleCoordonnee(entete.type) == 0){
+        fprintf(stderr, "Type de coordonnees inconnu : %d\n", type);
+        return 0;
+    }
+
+    if (nuage->nbPoint > 0){
+        entete.boite = 1;
+        entete.xmin = entete.xmax = nuage->x[0];
+        entete.ymin = entete.ymax = nuage->y[0];
+        int finies = 1;
+        for (int i = 0; i < nuage->nbPoint; i++){
+            entete.xmin = fmin(entete.xmin, nuage->x[i]);
+            entete.xmax = fmax(entete.xmax, nuage->x[i]);
+            entete.ymin = fmin(entete.ymin, nuage->y[i]);
+            entete.ymax = fmax(entete.ymax, nuage->y[i]);
+            finies &= isfinite(nuage->x[i]) && isfinite(nuage->y[i]);
+        }
+
+        // fmin et fmax ignorent les NaN : ils sont cherchés à part, avec les infinis
+        if (!finies){
+            fprintf(stderr, "Coordonnees non finies\n");
+            return 0;
+        }
+
+        if (type == COORD_INT32 && (fmin(entete.xmin, entete.ymin) < INT32_MIN
+                                    || fmax(entete.xmax, entete.ymax) > INT32_MAX)){
+            fprintf(stderr, "Coordonnees hors des entiers 32 bits\n");
+            return 0;
+        }
+
+        // La boîte est celle des coordonnées relues (les conversions sont croissantes)
+        entete.xmin = valeurEcrite(entete.xmin, entete.type);
+        entete.xmax = valeurEcrite(entete.xmax, entete.type);
+        entete.ymin = valeurEcrite(entete.ymin, entete.type);
+        entete.ymax = valeurEcrite(entete.ymax, entete.type);
+
+        if (!isfinite(entete.xmin) || !isfinite(entete.xmax) || !isfinite(entete.ymin) || !isfinite(entete.ymax)){
+            fprintf(stderr, "Coordonnees hors des reels 32 bits\n");
+            return 0;
+        }
+    }
+
+    FILE *f = fopen(chemin, "wb");
+    if (!f){
+        fprintf(stderr, "Impossible de creer %s\n", chemin);
+        return 0;
+    }
+
+    int ok = fwrite(&entete, sizeof entete, 1, f) == 1
+             && ecritCoordonnees(f, nuage->x, nuage->nbPoint, entete.type)
+             && ecritCoordonnees(f, nuage->y, nuage->nbPoint, entete.type);
+    ok = (fclose(f) == 0) && ok;
+
+    if (!ok){
+        fprintf(stderr, "Erreur d'ecriture de %s\n", chemin);
+    }
+
+    return ok;
+}
@@ -0,0 +1,77 @@
+#ifndef FICHIER_H
+#define FICHIER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "enveloppe.h"
+
+/*
+ * Fichier binaire de points : un en-tête de 64 octets, puis toutes les abscisses, puis toutes
+ * les ordonnées, dans l'ordre des octets de la machine. Ce sont les tableaux d'un NuagePoints :
+ * un fichier de doubles est projeté en mémoire (mmap) et donné tel quel aux calculs statiques,
+ * sans lecture ni copie. Les autres types de coordonnées sont convertis en doubles au chargement.
+ */
+
+#define FICHIER_MAGIE "ENVPTS1" /* les 8 premiers octets du fichier, '\0' compris */
+
+/* Types des coordonnées */
+#define COORD_DOUBLE 1
+#define COORD_FLOAT  2
+#define COORD_INT32  3
+
+/**
+ * @brief En-tête d'un fichier de points (64 octets)
+ *
+ */
+typedef struct{
+    char magie[8]; /* FICHIER_MAGIE */
+    uint32_t type; /* type des coordonnées (COORD_*) */
+    uint32_t boite; /* 1 si la boîte englobante est renseignée */
+    uint64_t nbPoint; /* nombre de points */
+    double xmin; /* boîte englobante des points */
+    double ymin;
+    double xmax;
+    double ymax;
+    uint64_t reserve; /* 0 */
+} EnTetePoints;
+
+/**
+ * @brief Fichier de points ouvert : son en-tête et le nuage de ses points
+ *
+ */
+typedef struct{
+    EnTetePoints entete; /* l'en-tête lu */
+    NuagePoints nuage; /* les points ; projetés depuis le fichier, ils ne doivent pas être modifiés */
+    void *projection; /* le fichier projeté en mémoire (NULL si les points ont été convertis) */
+    size_t taille; /* taille de la projection */
+} FichierPoints;
+
+/**
+ * @brief Ouvre un fichier de points. Un fichier de doubles est projeté en mémoire et son nuage
+ * pointe dans la projection : on ne doit pas lui ajouter de points. Un fichier dont une
+ * coordonnée n'est pas finie est refusé, qu'il soit projeté ou converti
+ *
+ * @param chemin Le chemin du fichier
+ * @param fichier Adresse du fichier ouvert à remplir
+ * @return 1 si le fichier a été ouvert, 0 sinon (la raison est écrite sur la sortie d'erreur)
+ */
+int ouvreFichierPoints(const char *chemin, FichierPoints *fichier);
+
+/**
+ * @brief Ferme un fichier ouvert par ouvreFichierPoints et libère ses points
+ */
+void fermeFichierPoints(FichierPoints *fichier);
+
+/**
+ * @brief Écrit les points d'un nuage dans un fichier de points, avec leur boîte englobante. Un
+ * nuage dont une coordonnée n'est pas finie, ou ne le serait plus une fois convertie, n'est pas écrit
+ *
+ * @param chemin Le chemin du fichier
+ * @param nuage Le nuage des points
+ * @param type Type des coordonnées écrites (COORD_*), les conversions arrondissent
+ * @return 1 si le fichier a été écrit, 0 sinon (la raison est écrite sur la sortie d'erreur)
+ */
+int ecritFichierPoints(const char *chemin, const NuagePoints *nuage, int type);
+
+#endif
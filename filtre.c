@@ -0,0 +1,350 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "filtre.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FILTRE_X86
+#include <immintrin.h>
+#endif
+
+typedef int (*NoyauFiltre)(const FiltreConvexe *filtre, const double *x, const double *y, int nbPoint, int *survivants);
+
+//////////////////////
+// Fonctions noyaux //
+//////////////////////
+
+/**
+ * @brief Indique si le point est sûrement strictement à gauche de toutes les arêtes du filtre,
+ * c'est-à-dire si orientationTriangle(A, B, P) renverrait 1 par le filtre flottant pour chaque
+ * arête [AB]
+ */
+static inline int interieurScalaire(const FiltreConvexe *filtre, double px, double py){
+    for (int i = 0; i < filtre->nbArete; i++){
+        double gauche = (filtre->ax[i] - px) * (filtre->by[i] - py);
+        double droite = (filtre->ay[i] - py) * (filtre->bx[i] - px);
+        double det = gauche - droite;
+
+        if (!(det > ERREUR_ORIENTATION * (fabs(gauche) + fabs(droite)))){
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int filtreScalaire(const FiltreConvexe *filtre, const double *x, const double *y, int nbPoint, int *survivants){
+    int nbSurvivant = 0;
+
+    for (int i = 0; i < nbPoint; i++){
+        if (!interieurScalaire(filtre, x[i], y[i])){
+            survivants[nbSurvivant++] = i;
+        }
+    }
+
+    return nbSurvivant;
+}
+
+#ifdef FILTRE_X86
+
+// Les noyaux n'utilisent que des multiplications et soustractions arrondies une à une, comme le
+// filtre flottant de orientationTriangle : la borne d'erreur reste valable (pas de fma ici)
+
+__attribute__((target("sse2")))
+static int filtreSSE2(const FiltreConvexe *filtre, const double *x, const double *y, int nbPoint, int *survivants){
+    const __m128d signe = _mm_set1_pd(-0.0);
+    const __m128d erreur = _mm_set1_pd(ERREUR_ORIENTATION);
+    int nbSurvivant = 0;
+    int i = 0;
+
+    for (; i + 2 <= nbPoint; i += 2){
+        __m128d px = _mm_loadu_pd(x + i);
+        __m128d py = _mm_loadu_pd(y + i);
+        __m128d dedans = _mm_castsi128_pd(_mm_set1_epi32(-1));
+
+        for (int a = 0; a < filtre->nbArete; a++){
+            __m128d gauche = _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(filtre->ax[a]), px),
+                                        _mm_sub_pd(_mm_set1_pd(filtre->by[a]), py));
+            __m128d droite = _mm_mul_pd(_mm_sub_pd(_mm_set1_pd(filtre->ay[a]), py),
+                                        _mm_sub_pd(_mm_set1_pd(filtre->bx[a]), px));
+            __m128d det = _mm_sub_pd(gauche, droite);
+            __m128d borne = _mm_mul_pd(erreur, _mm_add_pd(_mm_andnot_pd(signe, gauche),
+                                                          _mm_andnot_pd(signe, droite)));
+            dedans = _mm_and_pd(dedans, _mm_cmpgt_pd(det, borne));
+        }
+
+        int masque = _mm_movemask_pd(dedans);
+        if (!(masque & 1)){
+            survivants[nbSurvivant++] = i;
+        }
+        if (!(masque & 2)){
+            survivants[nbSurvivant++] = i + 1;
+        }
+    }
+
+    for (; i < nbPoint; i++){
+        if (!interieurScalaire(filtre, x[i], y[i])){
+            survivants[nbSurvivant++] = i;
+        }
+    }
+
+    return nbSurvivant;
+}
+
+__attribute__((target("avx2")))
+static int filtreAVX2(const FiltreConvexe *filtre, const double *x, const double *y, int nbPoint, int *survivants){
+    const __m256d signe = _mm256_set1_pd(-0.0);
+    const __m256d erreur = _mm256_set1_pd(ERREUR_ORIENTATION);
+    int nbSurvivant = 0;
+    int i = 0;
+
+    for (; i + 4 <= nbPoint; i += 4){
+        __m256d px = _mm256_loadu_pd(x + i);
+        __m256d py = _mm256_loadu_pd(y + i);
+        __m256d dedans = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+        for (int a = 0; a < filtre->nbArete; a++){
+            __m256d gauche = _mm256_mul_pd(_mm256_sub_pd(_mm256_broadcast_sd(filtre->ax + a), px),
+                                           _mm256_sub_pd(_mm256_broadcast_sd(filtre->by + a), py));
+            __m256d droite = _mm256_mul_pd(_mm256_sub_pd(_mm256_broadcast_sd(filtre->ay + a), py),
+                                           _mm256_sub_pd(_mm256_broadcast_sd(filtre->bx + a), px));
+            __m256d det = _mm256_sub_pd(gauche, droite);
+            __m256d borne = _mm256_mul_pd(erreur, _mm256_add_pd(_mm256_andnot_pd(signe, gauche),
+                                                                _mm256_andnot_pd(signe, droite)));
+            dedans = _mm256_and_pd(dedans, _mm256_cmp_pd(det, borne, _CMP_GT_OQ));
+        }
+
+        // Les bits à 0 sont les points gardés
+        int masque = ~_mm256_movemask_pd(dedans) & 0xF;
+        while (masque){
+            survivants[nbSurvivant++] = i + __builtin_ctz(masque);
+            masque &= masque - 1;
+        }
+    }
+
+    for (; i < nbPoint; i++){
+        if (!interieurScalaire(filtre, x[i], y[i])){
+            survivants[nbSurvivant++] = i;
+        }
+    }
+
+    return nbSurvivant;
+}
+
+#endif
+
+static NoyauFiltre noyauCourant = NULL;
+static int numeroNoyau = NOYAU_AUTO;
+
+int choisitNoyau(int noyau){
+    int meilleur = NOYAU_SCALAIRE;
+
+#ifdef FILTRE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")){
+        meilleur = NOYAU_AVX2;
+    }
+    else if (__builtin_cpu_supports("sse2")){
+        meilleur = NOYAU_SSE2;
+    }
+#endif
+
+    if (noyau == NOYAU_AUTO || noyau > meilleur){
+        noyau = meilleur;
+    }
+
+    switch (noyau){
+#ifdef FILTRE_X86
+        case NOYAU_AVX2:
+            noyauCourant = filtreAVX2;
+            break;
+        case NOYAU_SSE2:
+            noyauCourant = filtreSSE2;
+            break;
+#endif
+        default:
+            noyau = NOYAU_SCALAIRE;
+            noyauCourant = filtreScalaire;
+            break;
+    }
+
+    numeroNoyau = noyau;
+    return noyau;
+}
+
+const char *nomNoyau(void){
+    if (!noyauCourant){
+        choisitNoyau(NOYAU_AUTO);
+    }
+
+    switch (numeroNoyau){
+        case NOYAU_AVX2:
+            return "avx2";
+        case NOYAU_SSE2:
+            return "sse2";
+        default:
+            return "scalaire";
+    }
+}
+
+int filtrePoints(const FiltreConvexe *filtre, const double *x, const double *y, int nbPoint, int *survivants){
+    if (filtre->nbArete < 3){
+        for (int i = 0; i < nbPoint; i++){
+            survivants[i] = i;
+        }
+        return nbPoint;
+    }
+
+    if (!noyauCourant){
+        choisitNoyau(NOYAU_AUTO);
+    }
+
+    return noyauCourant(filtre, x, y, nbPoint, survivants);
+}
+
+//////////////////////
+// Fonctions filtre //
+//////////////////////
+
+void construitFiltre(FiltreConvexe *filtre, const ConvexHull *enveloppe){
+    const Vertex *anneau = enveloppe->anneau;
+    int nbSommet = (enveloppe->curlen < FILTRE_ARETES) ? enveloppe->curlen : FILTRE_ARETES;
+    Point sommets[FILTRE_ARETES];
+
+    // Le k-ième sommet retenu est le (k * curlen / nbSommet)-ième de l'anneau
+    int v = enveloppe->pol;
+    int k = 0;
+    for (int rang = 0; rang < enveloppe->curlen && k < nbSommet; rang++){
+        if ((long) rang * nbSommet >= (long) k * enveloppe->curlen){
+            sommets[k++] = anneau[v].p;
+        }
+        v = anneau[v].next;
+    }
+
+    for (int i = 0; i < nbSommet; i++){
+        Point a = sommets[i];
+        Point b = sommets[(i + 1) % nbSommet];
+        filtre->ax[i] = a.x;
+        filtre->ay[i] = a.y;
+        filtre->bx[i] = b.x;
+        filtre->by[i] = b.y;
+    }
+
+    filtre->nbArete = nbSommet;
+}
+
+/*
+ * Les huit directions de l'octogone, dans le sens de l'enveloppe : y min, x - y max, x max,
+ * x + y max, y max, x - y min, x min, x + y min. À égalité dans une direction, le point retenu est
+ * le plus loin dans la direction suivante, si bien que les sommets se suivent dans l'ordre de
+ * l'enveloppe. Même si un arrondi de x + y ou x - y dérangeait cet ordre, le filtre resterait
+ * juste : un point strictement à gauche de chaque arête d'un polygone fermé fait au moins un
+ * tour autour de lui, il est donc strictement intérieur à l'enveloppe de ses sommets
+ */
+static const double directions[8][2] = {
+    {0, -1}, {1, -1}, {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
+};
+
+int prefiltreOctogone(const NuagePoints *nuage, int debut, int fin, int *gardes){
+    int extremes[8];
+    double valeur[8][2];
+
+    if (fin <= debut){
+        return 0;
+    }
+
+    for (int d = 0; d < 8; d++){
+        const double *u = directions[d];
+        const double *w = directions[(d + 1) % 8];
+        extremes[d] = debut;
+        valeur[d][0] = u[0] * nuage->x[debut] + u[1] * nuage->y[debut];
+        valeur[d][1] = w[0] * nuage->x[debut] + w[1] * nuage->y[debut];
+    }
+
+    for (int i = debut + 1; i < fin; i++){
+        double x = nuage->x[i];
+        double y = nuage->y[i];
+
+        for (int d = 0; d < 8; d++){
+            const double *u = directions[d];
+            double v = u[0] * x + u[1] * y;
+
+            if (v >= valeur[d][0]){
+                const double *w = directions[(d + 1) % 8];
+                double suite = w[0] * x + w[1] * y;
+
+                if (v > valeur[d][0] || suite > valeur[d][1]){
+                    extremes[d] = i;
+                    valeur[d][0] = v;
+                    valeur[d][1] = suite;
+                }
+            }
+        }
+    }
+
+    // Sommets de l'octogone, sans les répétitions
+    Point sommets[8];
+    int nbSommet = 0;
+    for (int d = 0; d < 8; d++){
+        Point P = pointNuage(nuage, extremes[d]);
+        if (nbSommet == 0 || P.x != sommets[nbSommet - 1].x || P.y != sommets[nbSommet - 1].y){
+            sommets[nbSommet++] = P;
+        }
+    }
+    while (nbSommet > 1 && sommets[nbSommet - 1].x == sommets[0].x && sommets[nbSommet - 1].y == sommets[0].y){
+        nbSommet--;
+    }
+
+    FiltreConvexe filtre;
+    filtre.nbArete = (nbSommet >= 3) ? nbSommet : 0;
+    for (int i = 0; i < filtre.nbArete; i++){
+        filtre.ax[i] = sommets[i].x;
+        filtre.ay[i] = sommets[i].y;
+        filtre.bx[i] = sommets[(i + 1) % nbSommet].x;
+        filtre.by[i] = sommets[(i + 1) % nbSommet].y;
+    }
+
+    int nbGarde = filtrePoints(&filtre, nuage->x + debut, nuage->y + debut, fin - debut, gardes);
+    for (int i = 0; i < nbGarde; i++){
+        gardes[i] += debut;
+    }
+
+    return nbGarde;
+}
+
+void insereLotMoteur(Moteur *moteur, int debut, int fin){
+    const NuagePoints *nuage = moteur->nuage;
+    FiltreConvexe filtre;
+    int survivants[TAILLE_LOT];
+    int modifie = 0; // l'enveloppe a changé depuis la construction du filtre
+    int depuis = 0; // points filtrés depuis la construction du filtre
+
+    filtre.nbArete = 0;
+
+    for (int lot = debut; lot < fin; lot += TAILLE_LOT){
+        int nbPoint = (fin - lot < TAILLE_LOT) ? fin - lot : TAILLE_LOT;
+        ConvexHull *premiere = moteur->listeConvexe;
+
+        // En mode couches, un point intérieur n'est pas perdu : il descend dans les couches suivantes
+        if ((moteur->options & MOTEUR_COUCHES) || !premiere || premiere->curlen < 3){
+            for (int i = 0; i < nbPoint; i++){
+                insereMoteur(moteur, lot + i);
+            }
+            continue;
+        }
+
+        // L'ancien filtre reste juste (l'enveloppe ne fait que grandir) mais perd en efficacité : on
+        // le reconstruit au plus une fois tous les curlen points, ce qui amortit le parcours de l'anneau
+        if (filtre.nbArete < 3 || (modifie && depuis >= premiere->curlen)){
+            construitFiltre(&filtre, premiere);
+            modifie = 0;
+            depuis = 0;
+        }
+
+        int nbSurvivant = filtrePoints(&filtre, nuage->x + lot, nuage->y + lot, nbPoint, survivants);
+        for (int i = 0; i < nbSurvivant; i++){
+            modifie |= insereMoteur(moteur, lot + survivants[i]);
+        }
+        depuis += nbPoint;
+    }
+}
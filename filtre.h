@@ -0,0 +1,99 @@
+#ifndef FILTRE_H
+#define FILTRE_H
+
+#include "enveloppe.h"
+
+/*
+ * Insertion par lots : quand beaucoup de points arrivent d'un coup, la plupart sont intérieurs.
+ * Ils sont testés par blocs contre les arêtes d'un petit polygone inscrit dans l'enveloppe, avec
+ * un noyau vectoriel (AVX2 ou SSE2, choisi à l'exécution, sinon scalaire). Seuls les points qui
+ * ne sont pas sûrement intérieurs passent par insereMoteur.
+ */
+
+#define FILTRE_ARETES 16 /* nombre maximal d'arêtes du polygone de filtrage */
+#define TAILLE_LOT 1024 /* nombre de points filtrés d'un coup */
+
+/* Noyaux de filtrage */
+#define NOYAU_AUTO     0 /* le meilleur noyau disponible sur le processeur */
+#define NOYAU_SCALAIRE 1
+#define NOYAU_SSE2     2
+#define NOYAU_AVX2     3
+
+/**
+ * @brief Polygone convexe inscrit dans une enveloppe, rangé arête par arête pour le noyau
+ * vectoriel (l'arête i va de (ax[i], ay[i]) à (bx[i], by[i]), dans le sens de l'enveloppe)
+ *
+ */
+typedef struct{
+    int nbArete; /* nombre d'arêtes (0: pas de filtrage) */
+    double ax[FILTRE_ARETES];
+    double ay[FILTRE_ARETES];
+    double bx[FILTRE_ARETES];
+    double by[FILTRE_ARETES];
+} FiltreConvexe;
+
+/**
+ * @brief Construit le polygone de filtrage à partir d'au plus FILTRE_ARETES sommets de
+ * l'enveloppe, régulièrement espacés dans l'anneau. Comme ses sommets sont des sommets de
+ * l'enveloppe, un point strictement intérieur au polygone l'est aussi à l'enveloppe, et le
+ * reste tant que l'enveloppe ne fait que grandir
+ *
+ * @param filtre Adresse du filtre
+ * @param enveloppe L'enveloppe (au moins 3 sommets)
+ */
+void construitFiltre(FiltreConvexe *filtre, const ConvexHull *enveloppe);
+
+/**
+ * @brief Écarte les points sûrement strictement intérieurs au polygone de filtrage. Un point
+ * n'est écarté que si chaque déterminant dépasse sa borne d'erreur d'arrondi : le résultat est
+ * le même que celui du prédicat exact
+ *
+ * @param filtre Le filtre
+ * @param x Abscisses des points
+ * @param y Ordonnées des points
+ * @param nbPoint Nombre de points
+ * @param survivants Tableau (nbPoint cases) où écrire, dans l'ordre, les rangs des points gardés
+ * @return Le nombre de points gardés
+ */
+int filtrePoints(const FiltreConvexe *filtre, const double *x, const double *y, int nbPoint, int *survivants);
+
+/**
+ * @brief Choisit le noyau de filtrage. Un noyau que le processeur ne sait pas exécuter est
+ * remplacé par le meilleur noyau disponible
+ *
+ * @param noyau NOYAU_AUTO, NOYAU_SCALAIRE, NOYAU_SSE2 ou NOYAU_AVX2
+ * @return Le noyau effectivement choisi
+ */
+int choisitNoyau(int noyau);
+
+/**
+ * @brief Renvoie le nom du noyau de filtrage courant ("scalaire", "sse2" ou "avx2")
+ */
+const char *nomNoyau(void);
+
+/**
+ * @brief Préfiltre d'Akl-Toussaint : cherche les points extrêmes d'une plage du nuage dans huit
+ * directions (x, y, x + y et x - y, minimum et maximum), qui forment un octogone inscrit dans
+ * l'enveloppe, et écarte les points sûrement strictement intérieurs à cet octogone (avec le
+ * noyau de filtrage). Les points gardés ont la même enveloppe que toute la plage
+ *
+ * @param nuage Le nuage
+ * @param debut Indice du premier point de la plage
+ * @param fin Indice qui suit le dernier point de la plage
+ * @param gardes Tableau (fin - debut cases) où écrire, dans l'ordre, les indices des points gardés
+ * @return Le nombre de points gardés
+ */
+int prefiltreOctogone(const NuagePoints *nuage, int debut, int fin, int *gardes);
+
+/**
+ * @brief Insère dans le moteur les points d'indices debut à fin - 1 de son nuage. Le résultat
+ * est celui de insereMoteur point par point ; en mode MOTEUR_ENVELOPPE, les points intérieurs
+ * sont écartés par blocs avant l'insertion
+ *
+ * @param moteur Le moteur
+ * @param debut Indice du premier point
+ * @param fin Indice qui suit le dernier point
+ */
+void insereLotMoteur(Moteur *moteur, int debut, int fin);
+
+#endif
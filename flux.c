@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "flux.h"
+#include "statique.h"
+#include "filtre.h"
+
+int lisPoints(FILE *fichier, NuagePoints *nuage, int nbMax, long *nbInvalide){
+    char ligne[FLUX_LIGNE];
+    int nbLu = 0;
+
+    while (nbLu < nbMax && fgets(ligne, sizeof ligne, fichier)){
+        // Une ligne trop longue est sautée jusqu'à sa fin
+        if (!strchr(ligne, '\n') && !feof(fichier)){
+            int c;
+            while ((c = getc(fichier)) != '\n' && c != EOF){}
+            *nbInvalide += 1;
+            continue;
+        }
+
+        char *debut = ligne + strspn(ligne, " \t\r\n");
+        if (*debut == '\0' || *debut == '#'){
+            continue;
+        }
+
+        char *fin;
+        Point p;
+        p.x = strtod(debut, &fin);
+        if (fin == debut){
+            *nbInvalide += 1;
+            continue;
+        }
+        debut = fin;
+        p.y = strtod(debut, &fin);
+        if (fin == debut){
+            *nbInvalide += 1;
+            continue;
+        }
+
+        // strtod accepte "inf" et "nan", que les tests d'orientation ne savent pas classer, et
+        // s'arrête avant ce qui suit y : la ligne n'est gardée que si y est le dernier mot
+        fin += strspn(fin, " \t\r\n");
+        if (*fin != '\0' || !isfinite(p.x) || !isfinite(p.y)){
+            *nbInvalide += 1;
+            continue;
+        }
+
+        ajoutePoint(nuage, p);
+        nbLu += 1;
+    }
+
+    return nbLu;
+}
+
+void compacteMoteur(Moteur *moteur, NuagePoints *nuage){
+    ConvexHull *enveloppe = enveloppesMoteur(moteur);
+    int h = enveloppe ? enveloppe->curlen : 0;
+
+    // Les sommets sont recopiés avant d'écraser le nuage, auquel renvoient encore les vertex
+    Point *sommets = (Point *) malloc((h + 1) * sizeof(Point));
+    if (!sommets){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    int v = h ? enveloppe->pol : -1;
+    for (int i = 0; i < h; i++){
+        sommets[i] = enveloppe->anneau[v].p;
+        v = enveloppe->anneau[v].next;
+    }
+
+    nuage->nbPoint = 0;
+    for (int i = 0; i < h; i++){
+        ajoutePoint(nuage, sommets[i]);
+    }
+    free(sommets);
+
+    construitMoteur(moteur);
+}
+
+void ecritEnveloppe(FILE *fichier, const ConvexHull *enveloppe){
+    if (!enveloppe || enveloppe->curlen == 0){
+        return;
+    }
+
+    int v = enveloppe->pol;
+    do{
+        fprintf(fichier, "%.17g %.17g\n", enveloppe->anneau[v].p.x, enveloppe->anneau[v].p.y);
+        v = enveloppe->anneau[v].next;
+    } while (v != enveloppe->pol);
+}
+
+/**
+ * @brief Écrit l'enveloppe courante précédée d'une ligne d'en-tête
+ */
+static void ecritEtape(FILE *sortie, const Moteur *moteur, long nbLu, int fin){
+    const ConvexHull *enveloppe = enveloppesMoteur(moteur);
+
+    fprintf(sortie, "# %s : %ld points lus, %d sommets\n", fin ? "fin" : "etape", nbLu,
+            enveloppe ? enveloppe->curlen : 0);
+    ecritEnveloppe(sortie, enveloppe);
+    fflush(sortie);
+}
+
+long enveloppeFlux(FILE *entree, FILE *sortie, long periode){
+    NuagePoints nuage;
+    initNuage(&nuage, FLUX_LOT);
+
+    Moteur *moteur = creeMoteur(MOTEUR_ENVELOPPE, &nuage);
+    if (!moteur){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    long nbLu = 0;
+    long nbInvalide = 0;
+    long echeance = periode;
+    int nbLot;
+
+    while ((nbLot = lisPoints(entree, &nuage, FLUX_LOT, &nbInvalide)) > 0){
+        insereLotMoteur(moteur, nuage.nbPoint - nbLot, nuage.nbPoint);
+        compacteMoteur(moteur, &nuage);
+        nbLu += nbLot;
+
+        if (periode > 0 && nbLu >= echeance){
+            ecritEtape(sortie, moteur, nbLu, 0);
+            while (echeance <= nbLu){
+                echeance += periode;
+            }
+        }
+    }
+
+    ecritEtape(sortie, moteur, nbLu, 1);
+    if (nbInvalide){
+        fprintf(stderr, "%ld lignes illisibles ignorées\n", nbInvalide);
+    }
+
+    detruitMoteur(moteur);
+    libereNuage(&nuage);
+
+    return nbLu;
+}
@@ -0,0 +1,60 @@
+#ifndef FLUX_H
+#define FLUX_H
+
+#include <stdio.h>
+
+#include "enveloppe.h"
+
+/*
+ * Enveloppe d'un flux de points trop grand pour être gardé en mémoire : les points sont lus par
+ * lots, insérés dans le moteur, puis le nuage est réduit aux sommets de l'enveloppe. La mémoire
+ * est en O(h + FLUX_LOT) au lieu de O(n).
+ */
+
+#define FLUX_LOT 65536 /* nombre de points lus avant chaque réduction du nuage */
+#define FLUX_LIGNE 256 /* longueur maximale d'une ligne du flux */
+
+/**
+ * @brief Lit au plus nbMax points du fichier, un point "x y" par ligne, et les ajoute à la fin
+ * du nuage. Les lignes vides et celles qui commencent par '#' sont sautées ; celles dont une
+ * coordonnée n'est pas un réel fini, ou qui continuent après y, sont comptées comme illisibles
+ *
+ * @param fichier Le fichier lu
+ * @param nuage Le nuage où ajouter les points
+ * @param nbMax Nombre maximal de points à lire
+ * @param nbInvalide Adresse du compteur des lignes illisibles, augmenté au passage
+ * @return Le nombre de points lus (0 à la fin du fichier)
+ */
+int lisPoints(FILE *fichier, NuagePoints *nuage, int nbMax, long *nbInvalide);
+
+/**
+ * @brief Réduit le nuage d'un moteur MOTEUR_ENVELOPPE aux sommets de son enveloppe, puis
+ * reconstruit le moteur sur ce nuage. Les indices des points changent
+ *
+ * @param moteur Le moteur, qui travaille sur nuage
+ * @param nuage Le nuage du moteur
+ */
+void compacteMoteur(Moteur *moteur, NuagePoints *nuage);
+
+/**
+ * @brief Écrit les sommets d'une enveloppe, un point "x y" par ligne, dans l'ordre du polygone
+ *
+ * @param fichier Le fichier écrit
+ * @param enveloppe L'enveloppe (éventuellement NULL ou vide)
+ */
+void ecritEnveloppe(FILE *fichier, const ConvexHull *enveloppe);
+
+/**
+ * @brief Calcule l'enveloppe de tous les points d'un fichier sans les garder : lecture par lots
+ * de FLUX_LOT points, insertion par lots, puis réduction du nuage aux sommets de l'enveloppe.
+ * L'enveloppe est écrite à la fin du fichier, et aussi tous les periode points lus
+ *
+ * @param entree Le fichier des points
+ * @param sortie Le fichier où écrire les enveloppes
+ * @param periode Nombre de points entre deux écritures intermédiaires (0: seulement à la fin) ;
+ * une écriture a lieu à la fin du lot qui atteint l'échéance
+ * @return Le nombre de points lus
+ */
+long enveloppeFlux(FILE *entree, FILE *sortie, long periode);
+
+#endif
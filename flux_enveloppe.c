@@ -0,0 +1,39 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "flux.h"
+
+/*
+ * Enveloppe convexe d'un flux de points, sans les garder en mémoire : un point "x y" par ligne,
+ * lu sur l'entrée standard ou dans un fichier. L'enveloppe est écrite sur la sortie standard à
+ * la fin, et tous les periode points si periode est donnée. Compilé avec -DLATENCES, il écrit les
+ * latences des insertions sur la sortie d'erreur, et leur trace dans le fichier nommé par la
+ * variable d'environnement ENVELOPPE_TRACE.
+ *
+ * Utilisation : flux_enveloppe [fichier (-: entrée standard)] [periode]
+ */
+
+int main(int argc, char *argv[]){
+    FILE *entree = stdin;
+    long periode = (argc > 2) ? atol(argv[2]) : 0;
+
+    if (argc > 1 && strcmp(argv[1], "-") != 0){
+        entree = fopen(argv[1], "r");
+        if (!entree){
+            fprintf(stderr, "Impossible d'ouvrir %s\n", argv[1]);
+            return 1;
+        }
+    }
+
+    activeTrace(getenv("ENVELOPPE_TRACE") != NULL);
+    enveloppeFlux(entree, stdout, periode);
+    afficheLatences(stderr);
+    ecritTraceLatences(getenv("ENVELOPPE_TRACE"));
+
+    if (entree != stdin){
+        fclose(entree);
+    }
+
+    return 0;
+}
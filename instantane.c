@@ -0,0 +1,204 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "instantane.h"
+
+//////////////////////////
+// Fonctions instantané //
+//////////////////////////
+
+/**
+ * @brief Agrandit un tableau pour qu'il contienne au moins nb éléments
+ *
+ * @param tableau Adresse du tableau
+ * @param capacite Adresse de sa taille allouée
+ * @param nb Nombre d'éléments voulus
+ * @param taille Taille d'un élément
+ */
+static void reserveTableau(void **tableau, int *capacite, int nb, size_t taille){
+    if (nb <= *capacite){
+        return;
+    }
+
+    int nouvelle = *capacite ? 2 * *capacite : 64;
+    while (nouvelle < nb){
+        nouvelle *= 2;
+    }
+
+    void *agrandi = realloc(*tableau, nouvelle * taille);
+    if (!agrandi){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    *tableau = agrandi;
+    *capacite = nouvelle;
+}
+
+/**
+ * @brief Recopie les couches du moteur dans un instantané
+ */
+static void copieCouches(Instantane *instantane, const Moteur *moteur){
+    int nbCouche = 0;
+    int nbSommet = 0;
+    for (const ConvexHull *parcours = enveloppesMoteur(moteur); parcours; parcours = parcours->next){
+        nbCouche += 1;
+        nbSommet += parcours->curlen;
+    }
+
+    reserveTableau((void **) &(instantane->couches), &(instantane->capaciteCouches), nbCouche, sizeof(ConvexHull));
+    reserveTableau((void **) &(instantane->sommets), &(instantane->capaciteSommets), nbSommet, sizeof(Vertex));
+
+    // Chaque anneau est recopié dans l'ordre du polygone, à partir de son premier vertex
+    int c = 0;
+    int s = 0;
+    for (const ConvexHull *parcours = enveloppesMoteur(moteur); parcours; parcours = parcours->next, c++){
+        ConvexHull *couche = instantane->couches + c;
+        Vertex *anneau = instantane->sommets + s;
+        int curlen = parcours->curlen;
+
+        *couche = *parcours;
+        couche->pol = curlen ? 0 : -1;
+        couche->anneau = anneau;
+        couche->point = NULL;
+        couche->capacite = curlen;
+        couche->nbVertex = curlen;
+        couche->libre = -1;
+        couche->next = (c + 1 < nbCouche) ? couche + 1 : NULL;
+        couche->index = NULL;
+
+        int v = parcours->pol;
+        for (int i = 0; i < curlen; i++){
+            anneau[i].p = parcours->anneau[v].p;
+            anneau[i].prev = i ? i - 1 : curlen - 1;
+            anneau[i].next = (i + 1 < curlen) ? i + 1 : 0;
+            v = parcours->anneau[v].next;
+        }
+        s += curlen;
+    }
+
+    instantane->nbCouche = nbCouche;
+    instantane->nbSommet = nbSommet;
+    instantane->version = moteur->version;
+}
+
+///////////////////////
+// Fonctions échange //
+///////////////////////
+
+void initEchange(Echange *echange){
+    memset(echange->tampons, 0, sizeof(echange->tampons));
+    echange->rempli = 0;
+    echange->publie = 1;
+    echange->affiche = 2;
+    echange->nouveau = 0;
+    echange->termine = 0;
+    echange->nbPointAffiche = 0;
+    pthread_mutex_init(&(echange->verrou), NULL);
+    pthread_cond_init(&(echange->signal), NULL);
+}
+
+void publieInstantane(Echange *echange, const Moteur *moteur, const NuagePoints *nuage){
+    // Le tampon rempli n'appartient qu'au calcul : il est écrit sans verrou
+    Instantane *instantane = echange->tampons + echange->rempli;
+
+    pthread_mutex_lock(&(echange->verrou));
+    int premier = echange->nbPointAffiche;
+    pthread_mutex_unlock(&(echange->verrou));
+
+    copieCouches(instantane, moteur);
+
+    // Seuls les points que l'affichage n'a pas encore pris sont recopiés : ceux des instantanés
+    // sautés sont repris dans le suivant
+    if (nuage){
+        int nbPoint = nuage->nbPoint;
+        if (premier > nbPoint){
+            premier = nbPoint;
+        }
+
+        // y grandit avec x
+        int capacite = instantane->capacitePoints;
+        reserveTableau((void **) &(instantane->x), &(instantane->capacitePoints), nbPoint - premier, sizeof(double));
+        if (instantane->capacitePoints != capacite){
+            instantane->y = (double *) realloc(instantane->y, instantane->capacitePoints * sizeof(double));
+            if (!instantane->y){
+                fprintf(stderr,"Plus de memoire ");
+                exit(-1);
+            }
+        }
+        memcpy(instantane->x, nuage->x + premier, (nbPoint - premier) * sizeof(double));
+        memcpy(instantane->y, nuage->y + premier, (nbPoint - premier) * sizeof(double));
+
+        instantane->premierPoint = premier;
+        instantane->nbPoint = nbPoint;
+    }
+    else{
+        instantane->premierPoint = 0;
+        instantane->nbPoint = 0;
+    }
+
+    pthread_mutex_lock(&(echange->verrou));
+    int publie = echange->publie;
+    echange->publie = echange->rempli;
+    echange->rempli = publie;
+    echange->nouveau = 1;
+    pthread_cond_signal(&(echange->signal));
+    pthread_mutex_unlock(&(echange->verrou));
+}
+
+void termineEchange(Echange *echange){
+    pthread_mutex_lock(&(echange->verrou));
+    echange->termine = 1;
+    pthread_cond_signal(&(echange->signal));
+    pthread_mutex_unlock(&(echange->verrou));
+}
+
+/**
+ * @brief Prend le tampon publié s'il est nouveau (appelée sous verrou)
+ */
+static const Instantane *prendPublie(Echange *echange){
+    if (!echange->nouveau){
+        return NULL;
+    }
+
+    int affiche = echange->affiche;
+    echange->affiche = echange->publie;
+    echange->publie = affiche;
+    echange->nouveau = 0;
+
+    const Instantane *instantane = echange->tampons + echange->affiche;
+    echange->nbPointAffiche = instantane->nbPoint;
+    return instantane;
+}
+
+const Instantane *prendInstantane(Echange *echange){
+    pthread_mutex_lock(&(echange->verrou));
+    const Instantane *instantane = prendPublie(echange);
+    pthread_mutex_unlock(&(echange->verrou));
+
+    return instantane;
+}
+
+const Instantane *attendInstantane(Echange *echange){
+    pthread_mutex_lock(&(echange->verrou));
+    while (!echange->nouveau && !echange->termine){
+        pthread_cond_wait(&(echange->signal), &(echange->verrou));
+    }
+    const Instantane *instantane = prendPublie(echange);
+    pthread_mutex_unlock(&(echange->verrou));
+
+    return instantane;
+}
+
+void libereEchange(Echange *echange){
+    for (int i = 0; i < ECHANGE_TAMPONS; i++){
+        free(echange->tampons[i].couches);
+        free(echange->tampons[i].sommets);
+        free(echange->tampons[i].x);
+        free(echange->tampons[i].y);
+    }
+    memset(echange->tampons, 0, sizeof(echange->tampons));
+
+    pthread_mutex_destroy(&(echange->verrou));
+    pthread_cond_destroy(&(echange->signal));
+}
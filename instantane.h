@@ -0,0 +1,106 @@
+#ifndef INSTANTANE_H
+#define INSTANTANE_H
+
+#include <pthread.h>
+
+#include "enveloppe.h"
+
+/*
+ * Instantanés des couches du moteur, pour afficher le calcul depuis un autre thread. Le thread
+ * de calcul recopie les couches (et les points ajoutés) dans un instantané qui ne change plus
+ * une fois publié ; le thread d'affichage prend le dernier instantané publié quand il est prêt à
+ * dessiner, les précédents étant sautés. Les trois tampons de l'échange (celui que le calcul
+ * remplit, le dernier publié, celui qui est affiché) sont permutés sous verrou, si bien que le
+ * calcul n'attend jamais l'affichage et que l'affichage ne lit jamais un instantané en cours
+ * d'écriture.
+ */
+
+#define ECHANGE_TAMPONS 3 /* tampons d'un échange : rempli, publié, affiché */
+
+/**
+ * @brief Copie des couches du moteur à un instant donné. Les couches sont des ConvexHull sans
+ * index, dont les anneaux sont rangés à la suite dans un seul tableau, dans l'ordre du polygone
+ *
+ */
+typedef struct{
+    ConvexHull *couches; /* les couches, de l'extérieure vers l'intérieure, chaînées par next */
+    int nbCouche; /* nombre de couches */
+    int capaciteCouches; /* taille allouée de couches */
+    Vertex *sommets; /* les anneaux de toutes les couches */
+    int nbSommet; /* nombre de sommets */
+    int capaciteSommets; /* taille allouée de sommets */
+    unsigned long version; /* version du moteur copié */
+    double *x; /* abscisses des points ajoutés, à partir du point premierPoint */
+    double *y; /* ordonnées des points ajoutés */
+    int premierPoint; /* indice dans le nuage du premier point copié */
+    int nbPoint; /* nombre de points du nuage copié (0 si les points ne sont pas copiés) */
+    int capacitePoints; /* taille allouée de x et y */
+} Instantane;
+
+/**
+ * @brief Échange des instantanés entre le thread de calcul et le thread d'affichage
+ *
+ */
+typedef struct{
+    Instantane tampons[ECHANGE_TAMPONS]; /* les instantanés */
+    int rempli; /* tampon rempli par le calcul */
+    int publie; /* dernier tampon publié */
+    int affiche; /* tampon pris par l'affichage */
+    int nouveau; /* 1 si le tampon publié n'a pas encore été pris */
+    int termine; /* 1 quand le calcul ne publiera plus */
+    int nbPointAffiche; /* points du nuage dans le dernier instantané pris */
+    pthread_mutex_t verrou; /* protège les indices des tampons */
+    pthread_cond_t signal; /* signalé à chaque publication et à la fin du calcul */
+} Echange;
+
+/**
+ * @brief Renvoie la première couche d'un instantané (NULL si aucune)
+ */
+static inline const ConvexHull *premiereCouche(const Instantane *instantane){
+    return instantane->nbCouche ? instantane->couches : NULL;
+}
+
+/**
+ * @brief Prépare un échange vide
+ */
+void initEchange(Echange *echange);
+
+/**
+ * @brief Recopie les couches du moteur dans un instantané et le publie. Appelée par le thread de
+ * calcul, seul à modifier le moteur et le nuage
+ *
+ * @param echange L'échange
+ * @param moteur Le moteur
+ * @param nuage Le nuage, dont les points que l'affichage n'a pas encore pris sont recopiés
+ * (NULL: les points ne sont pas recopiés)
+ */
+void publieInstantane(Echange *echange, const Moteur *moteur, const NuagePoints *nuage);
+
+/**
+ * @brief Signale que le calcul ne publiera plus d'instantané
+ */
+void termineEchange(Echange *echange);
+
+/**
+ * @brief Prend le dernier instantané publié, s'il est nouveau. Il reste valide et inchangé
+ * jusqu'au prochain appel
+ *
+ * @param echange L'échange
+ * @return L'instantané, NULL si aucun n'a été publié depuis le dernier pris
+ */
+const Instantane *prendInstantane(Echange *echange);
+
+/**
+ * @brief Attend un nouvel instantané et le prend
+ *
+ * @param echange L'échange
+ * @return L'instantané, NULL si le calcul est terminé et que le dernier a déjà été pris
+ */
+const Instantane *attendInstantane(Echange *echange);
+
+/**
+ * @brief Libère les instantanés de l'échange
+ */
+void libereEchange(Echange *echange);
+
+#endif
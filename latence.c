@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "latence.h"
+
+#define SOUS_SEAUX (1 << LATENCE_PRECISION)
+
+/**
+ * @brief Un événement de la trace
+ *
+ */
+typedef struct{
+    uint64_t debut; /* heure de début en nanosecondes */
+    uint64_t duree; /* durée en nanosecondes */
+    int type; /* LATENCE_* */
+    int thread; /* numéro du thread dans la trace */
+} EvenementTrace;
+
+/**
+ * @brief Mesures retirées à un thread
+ *
+ */
+struct s_latences{
+    HistoLatence histos[LATENCE_TYPES]; /* ses histogrammes */
+    EvenementTrace *trace; /* ses événements */
+    int nbEvenement; /* nombre d'événements */
+};
+
+static const char *nomsLatence[LATENCE_TYPES] = {"insertion", "cascade", "dessin"};
+static const char *categoriesLatence[LATENCE_TYPES] = {"calcul", "calcul", "dessin"};
+
+__thread int profondeurLatence = 0;
+static __thread HistoLatence histos[LATENCE_TYPES];
+static __thread int traceActive = 0;
+static __thread EvenementTrace *trace = NULL;
+static __thread int nbEvenement = 0;
+static __thread int capaciteTrace = 0;
+
+////////////////////////////
+// Fonctions histogrammes //
+////////////////////////////
+
+/**
+ * @brief Renvoie le seau d'une durée : les durées sous 2^LATENCE_PRECISION ont chacune leur seau,
+ * puis chaque puissance de 2 est partagée en 2^LATENCE_PRECISION seaux de même largeur
+ */
+static int seauLatence(uint64_t v){
+    if (v < SOUS_SEAUX){
+        return (int) v;
+    }
+
+    int decalage = (63 - __builtin_clzll(v)) - LATENCE_PRECISION;
+    return ((decalage + 1) << LATENCE_PRECISION) + (int) ((v >> decalage) - SOUS_SEAUX);
+}
+
+/**
+ * @brief Renvoie la plus grande durée rangée dans un seau
+ */
+static uint64_t hautSeau(int seau){
+    if (seau < SOUS_SEAUX){
+        return (uint64_t) seau;
+    }
+
+    int groupe = seau >> LATENCE_PRECISION;
+    uint64_t mantisse = SOUS_SEAUX + (seau & (SOUS_SEAUX - 1));
+    return ((mantisse + 1) << (groupe - 1)) - 1;
+}
+
+/**
+ * @brief Agrandit la trace du thread appelant pour qu'elle contienne au moins nb événements
+ */
+static void reserveTrace(int nb){
+    if (nb <= capaciteTrace){
+        return;
+    }
+
+    int capacite = capaciteTrace ? 2 * capaciteTrace : 4096;
+    while (capacite < nb){
+        capacite *= 2;
+    }
+
+    EvenementTrace *evenements = (EvenementTrace *) realloc(trace, capacite * sizeof(EvenementTrace));
+    if (!evenements){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    trace = evenements;
+    capaciteTrace = capacite;
+}
+
+void enregistreLatence(int type, uint64_t debut, uint64_t duree){
+    HistoLatence *histo = histos + type;
+
+    histo->compte[seauLatence(duree)] += 1;
+    histo->nbMesure += 1;
+    histo->total += duree;
+    if (duree > histo->max){
+        histo->max = duree;
+    }
+
+    if (traceActive && nbEvenement < LATENCE_TRACE_MAX){
+        reserveTrace(nbEvenement + 1);
+
+        trace[nbEvenement].debut = debut;
+        trace[nbEvenement].duree = duree;
+        trace[nbEvenement].type = type;
+        trace[nbEvenement].thread = 1;
+        nbEvenement += 1;
+    }
+}
+
+uint64_t quantileLatence(const HistoLatence *histo, double q){
+    if (histo->nbMesure == 0){
+        return 0;
+    }
+
+    // Rang (à partir de 1) de la mesure cherchée
+    uint64_t rang = (uint64_t) (q * histo->nbMesure + 0.5);
+    if (rang < 1){
+        rang = 1;
+    }
+
+    uint64_t cumul = 0;
+    for (int seau = 0; seau < LATENCE_SEAUX; seau++){
+        cumul += histo->compte[seau];
+        if (cumul >= rang){
+            uint64_t haut = hautSeau(seau);
+            return (haut < histo->max) ? haut : histo->max;
+        }
+    }
+
+    return histo->max;
+}
+
+Latences *detacheLatences(void){
+    Latences *latences = (Latences *) malloc(sizeof(Latences));
+    if (!latences){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    memcpy(latences->histos, histos, sizeof histos);
+    latences->trace = trace;
+    latences->nbEvenement = nbEvenement;
+
+    memset(histos, 0, sizeof histos);
+    trace = NULL;
+    nbEvenement = 0;
+    capaciteTrace = 0;
+
+    return latences;
+}
+
+void rattacheLatences(Latences *latences, int thread){
+    for (int type = 0; type < LATENCE_TYPES; type++){
+        HistoLatence *histo = histos + type;
+        const HistoLatence *autre = latences->histos + type;
+
+        for (int seau = 0; seau < LATENCE_SEAUX; seau++){
+            histo->compte[seau] += autre->compte[seau];
+        }
+        histo->nbMesure += autre->nbMesure;
+        histo->total += autre->total;
+        if (autre->max > histo->max){
+            histo->max = autre->max;
+        }
+    }
+
+    reserveTrace(nbEvenement + latences->nbEvenement);
+    for (int i = 0; i < latences->nbEvenement; i++){
+        trace[nbEvenement] = latences->trace[i];
+        trace[nbEvenement].thread = thread;
+        nbEvenement += 1;
+    }
+
+    free(latences->trace);
+    free(latences);
+}
+
+void activeTrace(int active){
+    traceActive = active;
+}
+
+void remetLatences(void){
+    memset(histos, 0, sizeof histos);
+    nbEvenement = 0;
+}
+
+void afficheLatences(FILE *fichier){
+#ifdef LATENCES
+    fprintf(fichier, "latences (ns) %12s %10s %10s %10s %10s %10s\n", "mesures", "moyenne", "p50", "p99", "p999",
+            "max");
+    for (int type = 0; type < LATENCE_TYPES; type++){
+        const HistoLatence *histo = histos + type;
+        if (histo->nbMesure == 0){
+            continue;
+        }
+        fprintf(fichier, "  %-11s %12llu %10.0f %10llu %10llu %10llu %10llu\n", nomsLatence[type],
+                (unsigned long long) histo->nbMesure, (double) histo->total / histo->nbMesure,
+                (unsigned long long) quantileLatence(histo, 0.5), (unsigned long long) quantileLatence(histo, 0.99),
+                (unsigned long long) quantileLatence(histo, 0.999), (unsigned long long) histo->max);
+    }
+#else
+    (void) fichier;
+#endif
+}
+
+/////////////////////
+// Fonctions trace //
+/////////////////////
+
+int ecritTraceLatences(const char *chemin){
+    if (!chemin){
+        return 0;
+    }
+
+    FILE *fichier = fopen(chemin, "w");
+    if (!fichier){
+        fprintf(stderr, "Impossible de creer %s\n", chemin);
+        return 0;
+    }
+
+    // Événements complets ("X"), heures en microsecondes depuis le premier début. Un événement
+    // est rangé à sa fin : une cascade l'est avant l'insertion qui la contient
+    uint64_t origine = nbEvenement ? trace[0].debut : 0;
+    for (int i = 1; i < nbEvenement; i++){
+        if (trace[i].debut < origine){
+            origine = trace[i].debut;
+        }
+    }
+    fprintf(fichier, "{\"traceEvents\": [");
+    for (int i = 0; i < nbEvenement; i++){
+        const EvenementTrace *e = trace + i;
+        fprintf(fichier, "%s\n  {\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, "
+                "\"pid\": 1, \"tid\": %d}", i ? "," : "", nomsLatence[e->type], categoriesLatence[e->type],
+                (e->debut - origine) / 1e3, e->duree / 1e3, e->thread);
+    }
+    fprintf(fichier, "\n], \"displayTimeUnit\": \"ns\"}\n");
+
+    return fclose(fichier) == 0;
+}
@@ -0,0 +1,162 @@
+#ifndef LATENCE_H
+#define LATENCE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Latences des insertions en ligne, des cascades de traitementRecursif et des dessins, rangées
+ * dans des histogrammes à précision relative constante (à la HdrHistogram) qui donnent les
+ * quantiles p50, p99 et p999. Chaque mesure peut aussi être gardée comme événement d'une trace
+ * au format de chrome://tracing (Trace Event), pour retrouver si une image lente vient du calcul
+ * ou du dessin. Tout n'est compilé qu'avec -DLATENCES ; sinon les fonctions de mesure sont vides.
+ * Comme les compteurs, les mesures sont propres à chaque thread ; un thread peut les transmettre
+ * à un autre avant sa fin, et ses événements gardent leur propre ligne dans la trace.
+ */
+
+/* Types de mesures */
+#define LATENCE_INSERTION 0 /* un appel de insereMoteur, cascade comprise */
+#define LATENCE_CASCADE   1 /* un appel de traitementRecursif le plus extérieur */
+#define LATENCE_DESSIN    2 /* un dessin d'enveloppe */
+#define LATENCE_TYPES     3
+
+#define LATENCE_PRECISION 5 /* 2^5 sous-seaux par puissance de 2 : erreur relative d'au plus 1/32 */
+#define LATENCE_SEAUX ((64 - LATENCE_PRECISION + 1) << LATENCE_PRECISION) /* seaux d'un histogramme */
+#define LATENCE_TRACE_MAX (1 << 20) /* nombre maximal d'événements gardés dans la trace */
+
+/**
+ * @brief Histogramme de durées en nanosecondes
+ *
+ */
+typedef struct{
+    uint64_t compte[LATENCE_SEAUX]; /* mesures de chaque seau */
+    uint64_t nbMesure; /* nombre de mesures */
+    uint64_t total; /* somme des durées */
+    uint64_t max; /* plus grande durée */
+} HistoLatence;
+
+/**
+ * @brief Renvoie l'heure en nanosecondes depuis une origine arbitraire
+ */
+static inline uint64_t horlogeLatence(void){
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000u + (uint64_t) t.tv_nsec;
+}
+
+/**
+ * @brief Range une mesure dans l'histogramme de son type (et dans la trace si elle est active)
+ *
+ * @param type Le type de mesure (LATENCE_*)
+ * @param debut L'heure de début, donnée par horlogeLatence
+ * @param duree La durée en nanosecondes
+ */
+void enregistreLatence(int type, uint64_t debut, uint64_t duree);
+
+extern __thread int profondeurLatence;
+
+/**
+ * @brief Début d'une mesure
+ *
+ * @return L'heure de début (0 si les mesures ne sont pas compilées)
+ */
+static inline uint64_t debutLatence(void){
+#ifdef LATENCES
+    return horlogeLatence();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Fin d'une mesure commencée par debutLatence
+ */
+static inline void finLatence(int type, uint64_t debut){
+#ifdef LATENCES
+    enregistreLatence(type, debut, horlogeLatence() - debut);
+#else
+    (void) type;
+    (void) debut;
+#endif
+}
+
+/**
+ * @brief Entrée dans traitementRecursif : seul l'appel le plus extérieur est mesuré
+ */
+static inline uint64_t debutCascade(void){
+#ifdef LATENCES
+    if (profondeurLatence++ == 0){
+        return horlogeLatence();
+    }
+#endif
+    return 0;
+}
+
+/**
+ * @brief Sortie de traitementRecursif
+ */
+static inline void finCascade(uint64_t debut){
+#ifdef LATENCES
+    if (--profondeurLatence == 0){
+        enregistreLatence(LATENCE_CASCADE, debut, horlogeLatence() - debut);
+    }
+#else
+    (void) debut;
+#endif
+}
+
+/**
+ * @brief Renvoie la durée (borne supérieure de son seau) sous laquelle tombe la fraction q des
+ * mesures d'un histogramme
+ *
+ * @param histo L'histogramme
+ * @param q Fraction entre 0 et 1 (0.99 pour p99)
+ */
+uint64_t quantileLatence(const HistoLatence *histo, double q);
+
+typedef struct s_latences Latences;
+
+/**
+ * @brief Retire au thread appelant ses histogrammes et sa trace, pour les transmettre à un autre
+ * thread par rattacheLatences. Les mesures du thread appelant repartent de zéro
+ *
+ * @return Les mesures retirées
+ */
+Latences *detacheLatences(void);
+
+/**
+ * @brief Ajoute aux mesures du thread appelant celles retirées à un autre thread, et les libère
+ *
+ * @param latences Les mesures retirées par detacheLatences
+ * @param thread Numéro de l'autre thread dans la trace (le thread appelant a le numéro 1)
+ */
+void rattacheLatences(Latences *latences, int thread);
+
+/**
+ * @brief Active ou arrête l'enregistrement des événements de la trace du thread appelant
+ */
+void activeTrace(int active);
+
+/**
+ * @brief Remet à zéro les histogrammes et la trace du thread appelant
+ */
+void remetLatences(void);
+
+/**
+ * @brief Écrit les quantiles de chaque type de mesure du thread appelant. N'écrit rien si les
+ * mesures ne sont pas compilées
+ *
+ * @param fichier Le fichier écrit
+ */
+void afficheLatences(FILE *fichier);
+
+/**
+ * @brief Écrit la trace du thread appelant au format Trace Event (JSON) de chrome://tracing
+ *
+ * @param chemin Le chemin du fichier (NULL: rien n'est écrit)
+ * @return 1 si la trace a été écrite
+ */
+int ecritTraceLatences(const char *chemin);
+
+#endif
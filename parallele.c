@@ -0,0 +1,727 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "parallele.h"
+#include "statique.h"
+#include "filtre.h"
+#include "taches.h"
+
+/**
+ * @brief Travail d'un thread : une plage du nuage, puis les fusions de l'arbre de réduction
+ *
+ */
+typedef struct s_tache{
+    const NuagePoints *nuage; /* le nuage commun à tous les threads */
+    int debut; /* premier point de la plage */
+    int fin; /* point qui suit le dernier point de la plage */
+    int prefiltre; /* 1 pour appliquer le préfiltre d'Akl-Toussaint à la plage */
+    int nbPrefiltre; /* points de la plage écartés par le préfiltre */
+    int *sommets; /* l'enveloppe partielle (indices dans le nuage, dans l'ordre de l'enveloppe) */
+    int nbSommet; /* nombre de sommets de l'enveloppe partielle */
+    int numero; /* rang de la tâche */
+    int nbTache; /* nombre total de tâches */
+    struct s_tache *taches; /* toutes les tâches, pour la réduction */
+    pthread_t thread; /* le thread qui exécute la tâche (sauf pour la tâche 0) */
+} TacheEnveloppe;
+
+int nbCoeurs(void){
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int) n : 1;
+}
+
+/**
+ * @brief Renvoie 1 si le point d'indice a précède strictement celui d'indice b selon (x, y)
+ */
+static inline int precedeIndice(const NuagePoints *nuage, int a, int b){
+    return (nuage->x[a] < nuage->x[b]) || (nuage->x[a] == nuage->x[b] && nuage->y[a] < nuage->y[b]);
+}
+
+/**
+ * @brief Range les sommets d'une enveloppe selon (x, y) en temps linéaire : la chaîne inférieure
+ * est déjà croissante et la chaîne supérieure décroissante, il suffit de les interclasser
+ *
+ * @param sommets Les sommets, dans l'ordre de l'enveloppe en partant du plus petit
+ * @param nbSommet Nombre de sommets
+ * @param tries Tableau (nbSommet cases) où écrire les sommets triés
+ */
+static void trieSommets(const NuagePoints *nuage, const int *sommets, int nbSommet, int *tries){
+    if (nbSommet <= 0){
+        return;
+    }
+
+    // Le plus grand sommet termine la chaîne inférieure
+    int m = 0;
+    for (int i = 1; i < nbSommet; i++){
+        if (precedeIndice(nuage, sommets[m], sommets[i])){
+            m = i;
+        }
+    }
+
+    int i = 0; // chaîne inférieure, de 0 à m
+    int j = nbSommet - 1; // chaîne supérieure parcourue à l'envers, de nbSommet - 1 à m + 1
+    int k = 0;
+    while (i <= m && j > m){
+        if (precedeIndice(nuage, sommets[j], sommets[i])){
+            tries[k++] = sommets[j--];
+        }
+        else{
+            tries[k++] = sommets[i++];
+        }
+    }
+    while (i <= m){
+        tries[k++] = sommets[i++];
+    }
+    while (j > m){
+        tries[k++] = sommets[j--];
+    }
+}
+
+/**
+ * @brief Fusionne l'enveloppe partielle d'une autre tâche dans celle de la tâche. Les sommets des
+ * deux enveloppes sont interclassés selon (x, y), puis la chaîne monotone les balaie en temps
+ * linéaire : ses dépilements trouvent les ponts entre les deux polygones
+ */
+static void fusionne(TacheEnveloppe *tache, TacheEnveloppe *autre){
+    const NuagePoints *nuage = tache->nuage;
+    int na = tache->nbSommet;
+    int nb = autre->nbSommet;
+    int *a = (int *) malloc((na + nb + 1) * sizeof(int));
+    int *b = (int *) malloc((nb + 1) * sizeof(int));
+    int *tries = (int *) malloc((na + nb + 1) * sizeof(int));
+    if (!a || !b || !tries){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    trieSommets(nuage, tache->sommets, na, a);
+    trieSommets(nuage, autre->sommets, nb, b);
+
+    int i = 0;
+    int j = 0;
+    int k = 0;
+    while (i < na && j < nb){
+        tries[k++] = precedeIndice(nuage, b[j], a[i]) ? b[j++] : a[i++];
+    }
+    while (i < na){
+        tries[k++] = a[i++];
+    }
+    while (j < nb){
+        tries[k++] = b[j++];
+    }
+
+    free(tache->sommets);
+    free(autre->sommets);
+    autre->sommets = NULL;
+
+    // a, assez grand, reçoit la nouvelle enveloppe
+    tache->sommets = a;
+    tache->nbSommet = sommetsTries(nuage, tries, k, a);
+
+    free(b);
+    free(tries);
+}
+
+/**
+ * @brief Calcule l'enveloppe de la plage de la tâche, puis fusionne celles des tâches voisines :
+ * la tâche t reçoit la tâche t + pas pour chaque pas (1, 2, 4...) tant que t est multiple de 2 pas
+ */
+static void *travailleur(void *arg){
+    TacheEnveloppe *tache = (TacheEnveloppe *) arg;
+    const NuagePoints *nuage = tache->nuage;
+    int nbPoint = tache->fin - tache->debut;
+    int *indices = NULL;
+    int n = nbPoint;
+
+    if (tache->prefiltre){
+        indices = (int *) malloc(nbPoint * sizeof(int));
+        if (!indices){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        n = prefiltreOctogone(nuage, tache->debut, tache->fin, indices);
+        tache->nbPrefiltre = nbPoint - n;
+    }
+
+    tache->sommets = (int *) malloc((n + 1) * sizeof(int));
+    if (!tache->sommets){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    if (indices){
+        tache->nbSommet = sommetsEnveloppe(nuage, indices, n, tache->sommets);
+        free(indices);
+    }
+    else{
+        // Sans préfiltre, la plage est lue directement dans le nuage
+        NuagePoints plage = *nuage;
+        plage.x += tache->debut;
+        plage.y += tache->debut;
+        tache->nbSommet = sommetsEnveloppe(&plage, NULL, n, tache->sommets);
+        for (int i = 0; i < tache->nbSommet; i++){
+            tache->sommets[i] += tache->debut;
+        }
+    }
+
+    for (int pas = 1; pas < tache->nbTache; pas *= 2){
+        if (tache->numero % (2 * pas)){
+            break;
+        }
+        if (tache->numero + pas < tache->nbTache){
+            TacheEnveloppe *autre = tache->taches + tache->numero + pas;
+            pthread_join(autre->thread, NULL);
+            fusionne(tache, autre);
+        }
+    }
+
+    return NULL;
+}
+
+int enveloppeParallele(const NuagePoints *nuage, ConvexHull *enveloppe, int nbThread, int prefiltre){
+    int nbPoint = nuage->nbPoint;
+    enveloppe->curlen = 0;
+
+    if (nbPoint <= 0){
+        return 0;
+    }
+
+    if (nbThread <= 0){
+        nbThread = nbCoeurs();
+    }
+    if (nbThread > nbPoint / PARALLELE_MIN){
+        nbThread = nbPoint / PARALLELE_MIN;
+    }
+    if (nbThread < 1){
+        nbThread = 1;
+    }
+
+    TacheEnveloppe *taches = (TacheEnveloppe *) malloc(nbThread * sizeof(TacheEnveloppe));
+    if (!taches){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    // Le noyau de filtrage est choisi avant le lancement des threads
+    if (prefiltre){
+        nomNoyau();
+    }
+
+    for (int t = 0; t < nbThread; t++){
+        taches[t].nuage = nuage;
+        taches[t].debut = (int) ((long) nbPoint * t / nbThread);
+        taches[t].fin = (int) ((long) nbPoint * (t + 1) / nbThread);
+        taches[t].prefiltre = prefiltre;
+        taches[t].nbPrefiltre = 0;
+        taches[t].sommets = NULL;
+        taches[t].nbSommet = 0;
+        taches[t].numero = t;
+        taches[t].nbTache = nbThread;
+        taches[t].taches = taches;
+    }
+
+    // Une tâche n'attend que des tâches de rang supérieur : en les lançant du dernier rang vers le
+    // premier, leur identifiant de thread est rangé avant que quiconque ne l'attende
+    for (int t = nbThread - 1; t >= 1; t--){
+        if (pthread_create(&(taches[t].thread), NULL, travailleur, taches + t)){
+            fprintf(stderr,"Creation de thread impossible ");
+            exit(-1);
+        }
+    }
+
+    // La tâche 0 s'exécute dans le thread appelant et reçoit à la fin toutes les fusions
+    travailleur(taches);
+
+    int nbPrefiltre = 0;
+    for (int t = 0; t < nbThread; t++){
+        nbPrefiltre += taches[t].nbPrefiltre;
+    }
+
+    remplitEnveloppe(nuage, taches[0].sommets, taches[0].nbSommet, enveloppe);
+
+    free(taches[0].sommets);
+    free(taches);
+
+    return nbPrefiltre;
+}
+
+///////////////////////////////
+// QuickHull à vol de tâches //
+///////////////////////////////
+
+/*
+ * Chaque sous-problème est une arête (a, b) et l'ensemble des points strictement à sa droite
+ * (à l'extérieur), avec le plus éloigné c. Ses points sont partagés entre l'extérieur de (a, c)
+ * et celui de (c, b), les autres sont dans le triangle et disparaissent. Tous les ensembles
+ * vivent dans un seul tableau d'indices, partitionné sur place. Les sous-problèmes sont des
+ * tâches du groupe de threads, et les grosses partitions sont elles-mêmes découpées en tâches.
+ */
+
+/**
+ * @brief Données communes à toutes les tâches du QuickHull
+ *
+ */
+typedef struct{
+    const NuagePoints *nuage;
+    PoolTaches *pool;
+    GroupeTaches groupe; /* tous les sous-problèmes */
+} ContexteQH;
+
+/**
+ * @brief Sous-problème : l'arête (a, b) et les points à sa droite, dont le plus éloigné est c.
+ * Ses fils, rangés après coup, donnent les sommets entre a et c puis entre c et b
+ *
+ */
+typedef struct s_noeud_qh{
+    int a;
+    int b;
+    int c;
+    int *points; /* les points strictement à droite de (a, b), dans le tableau commun */
+    int nbPoint;
+    struct s_noeud_qh *gauche; /* sous-problème de l'arête (a, c) (NULL: aucun point) */
+    struct s_noeud_qh *droite; /* sous-problème de l'arête (c, b) (NULL: aucun point) */
+    ContexteQH *contexte;
+} NoeudQH;
+
+/**
+ * @brief Tranche d'un tableau d'indices traitée par une tâche
+ *
+ */
+typedef struct{
+    const NuagePoints *nuage;
+    int *points; /* le tableau entier */
+    int debut; /* première case de la tranche */
+    int fin; /* case qui suit la dernière case de la tranche */
+    int a1, b1, a2, b2; /* les deux arêtes de la partition */
+    int n1; /* points à droite de (a1, b1), rangés en tête de tranche */
+    int n2; /* points à droite de (a2, b2), rangés en fin de tranche */
+    int loin1; /* le plus éloigné de (a1, b1) (-1: aucun) */
+    int loin2; /* le plus éloigné de (a2, b2) (-1: aucun) */
+    double ecart1, ecart2; /* leurs écarts (négatifs) */
+    int min, max; /* plus petit et plus grand point selon (x, y) */
+} MorceauQH;
+
+/**
+ * @brief Renvoie le double du produit vectoriel (b - a) ^ (p - a) en double : négatif à droite de
+ * (a, b), d'autant plus que p en est loin. Sert seulement à choisir le point le plus éloigné,
+ * le côté est donné par orientationTriangle
+ */
+static inline double ecart(const NuagePoints *nuage, int a, int b, int p){
+    return (nuage->x[b] - nuage->x[a]) * (nuage->y[p] - nuage->y[a])
+         - (nuage->y[b] - nuage->y[a]) * (nuage->x[p] - nuage->x[a]);
+}
+
+/**
+ * @brief Partition sur place d'une tranche : les points à droite de (a1, b1) en tête, ceux à
+ * droite de (a2, b2) en fin, les autres sont écrasés
+ */
+static void partitionTranche(void *arg){
+    MorceauQH *m = (MorceauQH *) arg;
+    const NuagePoints *nuage = m->nuage;
+    int *points = m->points;
+    Point A1 = pointNuage(nuage, m->a1), B1 = pointNuage(nuage, m->b1);
+    Point A2 = pointNuage(nuage, m->a2), B2 = pointNuage(nuage, m->b2);
+    int lo = m->debut;
+    int hi = m->fin;
+    int i = m->debut;
+
+    m->loin1 = -1;
+    m->loin2 = -1;
+    m->ecart1 = 0;
+    m->ecart2 = 0;
+
+    while (i < hi){
+        int p = points[i];
+        Point P = pointNuage(nuage, p);
+
+        if (orientationTriangle(A1, B1, P) < 0){
+            double e = ecart(nuage, m->a1, m->b1, p);
+            if (m->loin1 < 0 || e < m->ecart1){
+                m->loin1 = p;
+                m->ecart1 = e;
+            }
+            points[lo++] = p;
+            i++;
+        }
+        else if (orientationTriangle(A2, B2, P) < 0){
+            double e = ecart(nuage, m->a2, m->b2, p);
+            if (m->loin2 < 0 || e < m->ecart2){
+                m->loin2 = p;
+                m->ecart2 = e;
+            }
+            points[i] = points[--hi];
+            points[hi] = p;
+        }
+        else{
+            i++;
+        }
+    }
+
+    m->n1 = lo - m->debut;
+    m->n2 = m->fin - hi;
+}
+
+static void extremesTranche(void *arg){
+    MorceauQH *m = (MorceauQH *) arg;
+    m->min = m->points[m->debut];
+    m->max = m->points[m->debut];
+
+    for (int i = m->debut + 1; i < m->fin; i++){
+        int p = m->points[i];
+        if (precedeIndice(m->nuage, p, m->min)){
+            m->min = p;
+        }
+        if (precedeIndice(m->nuage, m->max, p)){
+            m->max = p;
+        }
+    }
+}
+
+static void prefiltreTranche(void *arg){
+    MorceauQH *m = (MorceauQH *) arg;
+    m->n1 = prefiltreOctogone(m->nuage, m->debut, m->fin, m->points + m->debut);
+}
+
+static void identiteTranche(void *arg){
+    MorceauQH *m = (MorceauQH *) arg;
+    for (int i = m->debut; i < m->fin; i++){
+        m->points[i] = i;
+    }
+    m->n1 = m->fin - m->debut;
+}
+
+/**
+ * @brief Découpe n cases d'un tableau en tranches (une seule si n est petit ou s'il n'y a qu'un
+ * ouvrier) et exécute une fonction sur chacune, en parallèle
+ *
+ * @param morceaux Tableau (assez grand) des tranches, dont les champs communs sont déjà remplis
+ * @return Le nombre de tranches
+ */
+static int parTranches(ContexteQH *contexte, MorceauQH *morceaux, int n, void (*fonction)(void *)){
+    int nbOuvrier = nbOuvriers(contexte->pool);
+    int nbTranche = n / QUICKHULL_PARTITION;
+
+    if (nbTranche > 4 * nbOuvrier){
+        nbTranche = 4 * nbOuvrier;
+    }
+    if (nbTranche < 1 || nbOuvrier == 1){
+        nbTranche = 1;
+    }
+
+    for (int t = 1; t < nbTranche; t++){
+        morceaux[t] = morceaux[0];
+    }
+    for (int t = 0; t < nbTranche; t++){
+        morceaux[t].debut = (int) ((long) n * t / nbTranche);
+        morceaux[t].fin = (int) ((long) n * (t + 1) / nbTranche);
+    }
+
+    if (nbTranche == 1){
+        fonction(morceaux);
+        return 1;
+    }
+
+    GroupeTaches groupe;
+    initGroupe(&groupe);
+    for (int t = 0; t < nbTranche; t++){
+        lanceTache(contexte->pool, &groupe, fonction, morceaux + t);
+    }
+    attendsGroupe(contexte->pool, &groupe);
+
+    return nbTranche;
+}
+
+/**
+ * @brief Partitionne n points selon deux arêtes (en parallèle si n est grand) : les points à
+ * droite de (a1, b1) en tête du tableau, ceux à droite de (a2, b2) en fin
+ *
+ * @param resultat Reçoit n1, n2, loin1 et loin2
+ */
+static void partitionne(ContexteQH *contexte, int *points, int n, int a1, int b1, int a2, int b2, MorceauQH *resultat){
+    MorceauQH *morceaux = (MorceauQH *) malloc((4 * nbOuvriers(contexte->pool) + 1) * sizeof(MorceauQH));
+    if (!morceaux){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    morceaux[0].nuage = contexte->nuage;
+    morceaux[0].points = points;
+    morceaux[0].a1 = a1;
+    morceaux[0].b1 = b1;
+    morceaux[0].a2 = a2;
+    morceaux[0].b2 = b2;
+
+    int nbTranche = parTranches(contexte, morceaux, n, partitionTranche);
+    *resultat = morceaux[0];
+
+    if (nbTranche > 1){
+        // Regroupement des tranches par une copie : les déplacements sur place se chevaucheraient
+        int n1 = 0;
+        int n2 = 0;
+        for (int t = 0; t < nbTranche; t++){
+            n1 += morceaux[t].n1;
+            n2 += morceaux[t].n2;
+        }
+
+        int *copie = (int *) malloc((n1 + n2 + 1) * sizeof(int));
+        if (!copie){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+
+        int k1 = 0;
+        int k2 = n1;
+        for (int t = 0; t < nbTranche; t++){
+            MorceauQH *m = morceaux + t;
+            memcpy(copie + k1, points + m->debut, m->n1 * sizeof(int));
+            memcpy(copie + k2, points + m->fin - m->n2, m->n2 * sizeof(int));
+            k1 += m->n1;
+            k2 += m->n2;
+
+            if (m->loin1 >= 0 && (resultat->loin1 < 0 || m->ecart1 < resultat->ecart1)){
+                resultat->loin1 = m->loin1;
+                resultat->ecart1 = m->ecart1;
+            }
+            if (m->loin2 >= 0 && (resultat->loin2 < 0 || m->ecart2 < resultat->ecart2)){
+                resultat->loin2 = m->loin2;
+                resultat->ecart2 = m->ecart2;
+            }
+        }
+
+        memcpy(points, copie, n1 * sizeof(int));
+        memcpy(points + n - n2, copie + n1, n2 * sizeof(int));
+        resultat->n1 = n1;
+        resultat->n2 = n2;
+
+        free(copie);
+    }
+
+    free(morceaux);
+}
+
+static NoeudQH *nouveauNoeud(ContexteQH *contexte, int a, int b, int c, int *points, int nbPoint){
+    if (nbPoint == 0){
+        return NULL;
+    }
+
+    NoeudQH *noeud = (NoeudQH *) malloc(sizeof(NoeudQH));
+    if (!noeud){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    noeud->a = a;
+    noeud->b = b;
+    noeud->c = c;
+    noeud->points = points;
+    noeud->nbPoint = nbPoint;
+    noeud->gauche = NULL;
+    noeud->droite = NULL;
+    noeud->contexte = contexte;
+
+    return noeud;
+}
+
+/**
+ * @brief Résout un sous-problème : le plus gros fils part en tâche s'il est assez gros, le
+ * thread continue sur l'autre (la récursion directe ne porte que sur le plus petit)
+ */
+static void resousNoeud(void *arg){
+    NoeudQH *noeud = (NoeudQH *) arg;
+
+    while (noeud){
+        ContexteQH *contexte = noeud->contexte;
+        MorceauQH r;
+
+        partitionne(contexte, noeud->points, noeud->nbPoint, noeud->a, noeud->c, noeud->c, noeud->b, &r);
+
+        noeud->gauche = nouveauNoeud(contexte, noeud->a, noeud->c, r.loin1, noeud->points, r.n1);
+        noeud->droite = nouveauNoeud(contexte, noeud->c, noeud->b, r.loin2, noeud->points + noeud->nbPoint - r.n2, r.n2);
+
+        NoeudQH *petit = (r.n1 <= r.n2) ? noeud->gauche : noeud->droite;
+        NoeudQH *grand = (r.n1 <= r.n2) ? noeud->droite : noeud->gauche;
+
+        if (grand && grand->nbPoint > QUICKHULL_TACHE && nbOuvriers(contexte->pool) > 1){
+            lanceTache(contexte->pool, &(contexte->groupe), resousNoeud, grand);
+            noeud = petit;
+        }
+        else{
+            if (petit){
+                resousNoeud(petit);
+            }
+            noeud = grand;
+        }
+    }
+}
+
+/**
+ * @brief Ajoute à la suite des sommets ceux d'un arbre de sous-problèmes, dans l'ordre (parcours
+ * infixe avec une pile, l'arbre pouvant être profond), et libère l'arbre
+ *
+ * @return Le nouveau nombre de sommets
+ */
+static int rangeNoeuds(NoeudQH *racine, int *sommets, int k){
+    int capacite = 64;
+    int hauteur = 0;
+    NoeudQH **pile = (NoeudQH **) malloc(capacite * sizeof(NoeudQH *));
+    if (!pile){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    NoeudQH *noeud = racine;
+    while (noeud || hauteur > 0){
+        while (noeud){
+            if (hauteur == capacite){
+                capacite *= 2;
+                pile = (NoeudQH **) realloc(pile, capacite * sizeof(NoeudQH *));
+                if (!pile){
+                    fprintf(stderr,"Plus de memoire ");
+                    exit(-1);
+                }
+            }
+            pile[hauteur++] = noeud;
+            noeud = noeud->gauche;
+        }
+
+        noeud = pile[--hauteur];
+        sommets[k++] = noeud->c;
+
+        NoeudQH *droite = noeud->droite;
+        free(noeud);
+        noeud = droite;
+    }
+
+    free(pile);
+    return k;
+}
+
+/**
+ * @brief Vérifie que des sommets, dans l'ordre de l'enveloppe depuis le plus petit, forment une
+ * chaîne croissante puis décroissante selon (x, y), comme l'attend trieSommets
+ */
+static int estMonotone(const NuagePoints *nuage, const int *sommets, int k){
+    int i = 1;
+    while (i < k && precedeIndice(nuage, sommets[i - 1], sommets[i])){
+        i++;
+    }
+    while (i < k && precedeIndice(nuage, sommets[i], sommets[i - 1])){
+        i++;
+    }
+
+    return i >= k && (k < 2 || precedeIndice(nuage, sommets[0], sommets[k - 1]));
+}
+
+int quickHullParallele(const NuagePoints *nuage, ConvexHull *enveloppe, int nbThread, int prefiltre){
+    int nbPoint = nuage->nbPoint;
+    enveloppe->curlen = 0;
+
+    if (nbPoint <= 0){
+        return 0;
+    }
+
+    if (nbThread <= 0){
+        nbThread = nbCoeurs();
+    }
+
+    // Le noyau de filtrage est choisi avant le lancement des threads
+    if (prefiltre){
+        nomNoyau();
+    }
+
+    ContexteQH contexte;
+    contexte.nuage = nuage;
+    contexte.pool = creePoolTaches(nbThread);
+    if (!contexte.pool){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    initGroupe(&(contexte.groupe));
+
+    int *points = (int *) malloc(nbPoint * sizeof(int));
+    MorceauQH *morceaux = (MorceauQH *) malloc((4 * nbOuvriers(contexte.pool) + 1) * sizeof(MorceauQH));
+    if (!points || !morceaux){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    // Les points de départ, préfiltrés par tranche puis regroupés en tête
+    morceaux[0].nuage = nuage;
+    morceaux[0].points = points;
+    int nbTranche = parTranches(&contexte, morceaux, nbPoint, prefiltre ? prefiltreTranche : identiteTranche);
+    int n = 0;
+    for (int t = 0; t < nbTranche; t++){
+        memmove(points + n, points + morceaux[t].debut, morceaux[t].n1 * sizeof(int));
+        n += morceaux[t].n1;
+    }
+    int nbPrefiltre = nbPoint - n;
+
+    // A et B, le plus petit et le plus grand point, séparent la chaîne inférieure de la supérieure
+    nbTranche = parTranches(&contexte, morceaux, n, extremesTranche);
+    int A = morceaux[0].min;
+    int B = morceaux[0].max;
+    for (int t = 1; t < nbTranche; t++){
+        if (precedeIndice(nuage, morceaux[t].min, A)){
+            A = morceaux[t].min;
+        }
+        if (precedeIndice(nuage, B, morceaux[t].max)){
+            B = morceaux[t].max;
+        }
+    }
+    free(morceaux);
+
+    MorceauQH r;
+    partitionne(&contexte, points, n, A, B, B, A, &r);
+    NoeudQH *inferieure = nouveauNoeud(&contexte, A, B, r.loin1, points, r.n1);
+    NoeudQH *superieure = nouveauNoeud(&contexte, B, A, r.loin2, points + n - r.n2, r.n2);
+
+    if (inferieure){
+        lanceTache(contexte.pool, &(contexte.groupe), resousNoeud, inferieure);
+    }
+    if (superieure){
+        lanceTache(contexte.pool, &(contexte.groupe), resousNoeud, superieure);
+    }
+    attendsGroupe(contexte.pool, &(contexte.groupe));
+    detruitPoolTaches(contexte.pool);
+
+    // Chaque noeud a donné un sommet : il y en a au plus n
+    int k = 0;
+    points[k++] = A;
+    k = rangeNoeuds(inferieure, points, k);
+    if (B != A && precedeIndice(nuage, A, B)){
+        points[k++] = B;
+    }
+    k = rangeNoeuds(superieure, points, k);
+
+    // Le point le plus éloigné est choisi en double : un balayage exact des candidats, linéaire
+    // s'ils sont rangés comme attendu, garantit le même polygone que le calcul séquentiel
+    int *sommets = (int *) malloc((k + 1) * sizeof(int));
+    if (!sommets){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    int nbSommet;
+    if (estMonotone(nuage, points, k)){
+        int *tries = (int *) malloc(k * sizeof(int));
+        if (!tries){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        trieSommets(nuage, points, k, tries);
+        nbSommet = sommetsTries(nuage, tries, k, sommets);
+        free(tries);
+    }
+    else{
+        nbSommet = sommetsEnveloppe(nuage, points, k, sommets);
+    }
+
+    remplitEnveloppe(nuage, sommets, nbSommet, enveloppe);
+
+    free(sommets);
+    free(points);
+
+    return nbPrefiltre;
+}
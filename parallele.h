@@ -0,0 +1,49 @@
+#ifndef PARALLELE_H
+#define PARALLELE_H
+
+#include "enveloppe.h"
+
+/*
+ * Constructions parallèles de l'enveloppe :
+ * - diviser pour régner : le nuage est découpé en plages contiguës, chaque thread calcule
+ *   l'enveloppe de sa plage, puis les enveloppes partielles sont fusionnées deux à deux en arbre
+ *   de réduction ;
+ * - QuickHull : les sous-problèmes (une arête et les points à l'extérieur) sont des tâches d'un
+ *   groupe de threads à vol de tâches, ce qui équilibre les découpages inégaux (nuages en amas).
+ */
+
+#define PARALLELE_MIN 65536 /* nombre minimal de points par thread */
+#define QUICKHULL_TACHE 4096 /* taille au-delà de laquelle un sous-problème devient une tâche */
+#define QUICKHULL_PARTITION 65536 /* taille au-delà de laquelle une partition est découpée en tâches */
+
+/**
+ * @brief Renvoie le nombre de processeurs disponibles (au moins 1)
+ */
+int nbCoeurs(void);
+
+/**
+ * @brief Calcule l'enveloppe convexe de tous les points du nuage avec plusieurs threads. Le
+ * polygone obtenu est le même que celui de enveloppeStatique
+ *
+ * @param nuage Le nuage des points
+ * @param enveloppe L'adresse d'une enveloppe vide (pol == -1)
+ * @param nbThread Nombre de threads (0: un par processeur) ; réduit pour que chaque thread ait
+ * au moins PARALLELE_MIN points
+ * @param prefiltre 1 pour appliquer le préfiltre d'Akl-Toussaint à chaque plage
+ * @return Le nombre de points écartés par le préfiltre
+ */
+int enveloppeParallele(const NuagePoints *nuage, ConvexHull *enveloppe, int nbThread, int prefiltre);
+
+/**
+ * @brief Calcule l'enveloppe convexe de tous les points du nuage par un QuickHull parallèle. Le
+ * polygone obtenu est le même que celui de enveloppeStatique
+ *
+ * @param nuage Le nuage des points
+ * @param enveloppe L'adresse d'une enveloppe vide (pol == -1)
+ * @param nbThread Nombre de threads (0: un par processeur)
+ * @param prefiltre 1 pour appliquer d'abord le préfiltre d'Akl-Toussaint (par tranches)
+ * @return Le nombre de points écartés par le préfiltre
+ */
+int quickHullParallele(const NuagePoints *nuage, ConvexHull *enveloppe, int nbThread, int prefiltre);
+
+#endif
@@ -0,0 +1,72 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pool.h"
+
+/* L'en-tête de bloc est arrondi pour que les noeuds restent alignés */
+#define ALIGNEMENT 16
+#define TAILLE_ENTETE ((sizeof(BlocPool) + ALIGNEMENT - 1) / ALIGNEMENT * ALIGNEMENT)
+
+void initPool(Pool *pool, size_t taille, int parBloc){
+    // Un noeud libre contient le lien vers le noeud libre suivant
+    if (taille < sizeof(void *)){
+        taille = sizeof(void *);
+    }
+
+    pool->taille = (taille + sizeof(void *) - 1) / sizeof(void *) * sizeof(void *);
+    pool->parBloc = (parBloc > 0) ? parBloc : POOL_BLOC_MIN;
+    pool->libres = NULL;
+    pool->courant = NULL;
+    pool->restants = 0;
+    pool->blocs = NULL;
+}
+
+void *allouePool(Pool *pool){
+    if (pool->libres){
+        void *noeud = pool->libres;
+        pool->libres = *((void **) noeud);
+        return noeud;
+    }
+
+    if (!pool->restants){
+        BlocPool *bloc = (BlocPool *) malloc(TAILLE_ENTETE + (size_t) pool->parBloc * pool->taille);
+        if (!bloc){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+
+        bloc->next = pool->blocs;
+        pool->blocs = bloc;
+        pool->courant = (char *) bloc + TAILLE_ENTETE;
+        pool->restants = pool->parBloc;
+
+        if (pool->parBloc < POOL_BLOC_MAX){
+            pool->parBloc *= 2;
+        }
+    }
+
+    void *noeud = pool->courant;
+    pool->courant += pool->taille;
+    pool->restants -= 1;
+
+    return noeud;
+}
+
+void rendPool(Pool *pool, void *noeud){
+    *((void **) noeud) = pool->libres;
+    pool->libres = noeud;
+}
+
+void liberePool(Pool *pool){
+    BlocPool *bloc = pool->blocs;
+    while (bloc){
+        BlocPool *next = bloc->next;
+        free(bloc);
+        bloc = next;
+    }
+
+    pool->blocs = NULL;
+    pool->libres = NULL;
+    pool->courant = NULL;
+    pool->restants = 0;
+}
@@ -0,0 +1,70 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+/*
+ * Allocateur par blocs pour les noeuds de taille fixe, aujourd'hui les noeuds de l'index
+ * angulaire des enveloppes (NoeudAngle), partagés par toutes les couches d'un moteur ; les
+ * vertex et les points sont rangés dans des tableaux. Les noeuds sont découpés dans de grands
+ * blocs, les noeuds rendus sont recyclés par une liste de noeuds libres, et tout est libéré d'un
+ * coup à la fin.
+ */
+
+#define POOL_BLOC_MIN 256 /* nombre de noeuds du premier bloc sans indication de taille */
+#define POOL_BLOC_MAX 65536 /* les blocs suivants doublent jusqu'à cette taille */
+
+/**
+ * @brief En-tête d'un bloc, les blocs sont chaînés pour la libération
+ *
+ */
+typedef struct s_bloc_pool{
+    struct s_bloc_pool *next;
+} BlocPool;
+
+/**
+ * @brief Pool de noeuds de même taille
+ *
+ */
+typedef struct{
+    size_t taille; /* taille d'un noeud, arrondie pour l'alignement */
+    int parBloc; /* nombre de noeuds du prochain bloc */
+    void *libres; /* liste des noeuds rendus */
+    char *courant; /* premier noeud jamais servi du bloc courant */
+    int restants; /* nombre de noeuds jamais servis du bloc courant */
+    BlocPool *blocs; /* tous les blocs alloués */
+} Pool;
+
+/**
+ * @brief Initialise un pool vide
+ *
+ * @param pool Adresse du pool
+ * @param taille Taille d'un noeud
+ * @param parBloc Nombre de noeuds du premier bloc (0: POOL_BLOC_MIN)
+ */
+void initPool(Pool *pool, size_t taille, int parBloc);
+
+/**
+ * @brief Renvoie un noeud du pool, recyclé si possible. Arrête le programme si plus de mémoire
+ *
+ * @param pool Adresse du pool
+ * @return L'adresse du noeud
+ */
+void *allouePool(Pool *pool);
+
+/**
+ * @brief Rend un noeud au pool, qui le recyclera à la prochaine allocation
+ *
+ * @param pool Adresse du pool
+ * @param noeud Le noeud à rendre
+ */
+void rendPool(Pool *pool, void *noeud);
+
+/**
+ * @brief Libère d'un coup tous les blocs du pool. Le pool reste utilisable
+ *
+ * @param pool Adresse du pool
+ */
+void liberePool(Pool *pool);
+
+#endif
@@ -0,0 +1,980 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "raster.h"
+#include "rendu.h"
+#include "parallele.h"
+#include "taches.h"
+
+#define PIXEL_MAX (1 << 28) /* les coordonnées en pixels sont bornées à [-PIXEL_MAX, PIXEL_MAX] */
+
+const Couleur couleursCouches[] = {
+    {255, 0, 0}, {175, 0, 0},
+    {255, 255, 0}, {255, 200, 0},
+    {0, 255, 0}, {0, 100, 0},
+    {155, 48, 255},
+    {0, 0, 255}, {0, 0, 175}
+};
+const int nbCouleursCouches = sizeof(couleursCouches) / sizeof(couleursCouches[0]);
+
+/**
+ * @brief Scène convertie en pixels avant le dessin des tuiles, qui la lisent sans la modifier
+ *
+ */
+typedef struct{
+    const Scene *scene; /* la scène */
+    int nbCouche; /* couches dessinées */
+    int *debut; /* sommets de la couche c : px et py de debut[c] à debut[c + 1] */
+    int *px; /* abscisses des sommets de toutes les couches, dans l'ordre des polygones */
+    int *py; /* ordonnées des sommets */
+    Zone *boites; /* boîte de chaque couche, disques des sommets compris */
+    Couleur *couleurs; /* couleur de chaque couche */
+    int nbTuileX; /* tuiles par ligne */
+    int nbTuileY; /* lignes de tuiles */
+    int *debutTuile; /* points de la tuile t : pointsTuiles de 2 * debutTuile[t] à 2 * debutTuile[t + 1] */
+    int *pointsTuiles; /* centres (x, y) des disques des points qui touchent chaque tuile */
+    Densite densite; /* les points comptés par pixel, si la scène le demande */
+} Preparation;
+
+/**
+ * @brief Tranche de points ou bande de pixels de la carte de densité, argument d'une tâche
+ *
+ */
+typedef struct{
+    const NuagePoints *nuage; /* le nuage */
+    int debut; /* premier point de la tranche, ou premier pixel de la bande */
+    int fin; /* fin de la tranche ou de la bande */
+    double echelle; /* facteur des coordonnées */
+    double dx; /* décalage des abscisses */
+    double dy; /* décalage des ordonnées */
+    int largeur; /* dimensions de la carte */
+    int hauteur;
+    uint32_t *comptes; /* tampon de la tranche ; pour une bande, la carte où additionner */
+    uint32_t **tampons; /* pour une bande, les tampons des tranches */
+    int nbTampon; /* nombre de tampons */
+    uint32_t max; /* plus grand compte de la bande */
+} TacheDensite;
+
+/**
+ * @brief Tuile à dessiner, argument d'une tâche
+ *
+ */
+typedef struct{
+    const Preparation *preparation; /* la scène en pixels */
+    Image *image; /* l'image dessinée */
+    Zone tuile; /* les pixels de la tuile */
+    int numero; /* rang de la tuile, ligne par ligne */
+} TacheTuile;
+
+//////////////////////
+// Fonctions images //
+//////////////////////
+
+void creeImage(Image *image, int largeur, int hauteur){
+    image->largeur = largeur;
+    image->hauteur = hauteur;
+    image->pixels = (unsigned char *) malloc((size_t) largeur * hauteur * 3);
+    if (!image->pixels){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+}
+
+void libereImage(Image *image){
+    free(image->pixels);
+    image->pixels = NULL;
+    image->largeur = image->hauteur = 0;
+}
+
+int ecritPPM(const Image *image, const char *chemin){
+    FILE *sortie = fopen(chemin, "wb");
+    if (!sortie){
+        fprintf(stderr, "Impossible d'ouvrir %s\n", chemin);
+        return 0;
+    }
+
+    size_t taille = (size_t) image->largeur * image->hauteur * 3;
+    int ok = fprintf(sortie, "P6\n%d %d\n255\n", image->largeur, image->hauteur) > 0;
+    ok = ok && fwrite(image->pixels, 1, taille, sortie) == taille;
+    ok = (fclose(sortie) == 0) && ok;
+    if (!ok){
+        fprintf(stderr, "Erreur d'ecriture de %s\n", chemin);
+    }
+
+    return ok;
+}
+
+int ecritImage(const Image *image, const char *chemin){
+    size_t n = strlen(chemin);
+    if (n >= 4 && strcmp(chemin + n - 4, ".png") == 0){
+        return ecritPNG(image, chemin);
+    }
+    return ecritPPM(image, chemin);
+}
+
+///////////////////
+// Fonctions PNG //
+///////////////////
+
+/**
+ * @brief Flux de bits d'un bloc deflate, écrit en mémoire, bit de poids faible en premier
+ *
+ */
+typedef struct{
+    unsigned char *octets; /* les octets écrits */
+    size_t nbOctet; /* nombre d'octets écrits */
+    size_t capacite; /* taille allouée d'octets */
+    uint32_t reste; /* bits pas encore écrits */
+    int nbReste; /* nombre de ces bits */
+} Bits;
+
+/**
+ * @brief Ajoute un octet à un flux de bits
+ */
+static void ajouteOctet(Bits *bits, unsigned char octet){
+    if (bits->nbOctet == bits->capacite){
+        bits->capacite = bits->capacite ? 2 * bits->capacite : 4096;
+        bits->octets = (unsigned char *) realloc(bits->octets, bits->capacite);
+        if (!bits->octets){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+    }
+    bits->octets[bits->nbOctet++] = octet;
+}
+
+/**
+ * @brief Écrit les nb bits de poids faible d'une valeur, poids faible en premier
+ */
+static void ecritBits(Bits *bits, uint32_t valeur, int nb){
+    bits->reste |= valeur << bits->nbReste;
+    bits->nbReste += nb;
+    while (bits->nbReste >= 8){
+        ajouteOctet(bits, bits->reste & 0xff);
+        bits->reste >>= 8;
+        bits->nbReste -= 8;
+    }
+}
+
+/**
+ * @brief Écrit un code de Huffman, poids fort en premier
+ */
+static void ecritCode(Bits *bits, uint32_t code, int longueur){
+    uint32_t inverse = 0;
+    for (int i = 0; i < longueur; i++){
+        inverse = (inverse << 1) | ((code >> i) & 1);
+    }
+    ecritBits(bits, inverse, longueur);
+}
+
+/**
+ * @brief Écrit un symbole littéral ou de longueur avec les codes fixes de deflate
+ */
+static void ecritSymbole(Bits *bits, int symbole){
+    if (symbole < 144){
+        ecritCode(bits, 0x30 + symbole, 8);
+    }
+    else if (symbole < 256){
+        ecritCode(bits, 0x190 + symbole - 144, 9);
+    }
+    else if (symbole < 280){
+        ecritCode(bits, symbole - 256, 7);
+    }
+    else{
+        ecritCode(bits, 0xc0 + symbole - 280, 8);
+    }
+}
+
+/**
+ * @brief Écrit la répétition du dernier octet longueur fois (3 à 258), à la distance 1
+ */
+static void ecritRepetition(Bits *bits, int longueur){
+    static const int bases[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83,
+                                99, 115, 131, 163, 195, 227, 258};
+    static const int extras[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5,
+                                 5, 0};
+
+    int c = 28;
+    while (bases[c] > longueur){
+        c--;
+    }
+    ecritSymbole(bits, 257 + c);
+    ecritBits(bits, longueur - bases[c], extras[c]);
+    // Code fixe de la distance 1
+    ecritCode(bits, 0, 5);
+}
+
+/**
+ * @brief Compresse des octets en un flux zlib fait d'un seul bloc deflate à codes fixes, où
+ * seules les répétitions d'un même octet sont codées
+ */
+static void compresse(Bits *bits, const unsigned char *donnees, size_t n){
+    // En-tête zlib : deflate, fenêtre de 32 Ko, sans dictionnaire
+    ajouteOctet(bits, 0x78);
+    ajouteOctet(bits, 0x01);
+    ecritBits(bits, 1, 1);
+    ecritBits(bits, 1, 2);
+
+    size_t i = 0;
+    while (i < n){
+        size_t j = i + 1;
+        while (j < n && donnees[j] == donnees[i]){
+            j++;
+        }
+
+        ecritSymbole(bits, donnees[i]);
+        size_t repetes = j - i - 1;
+        while (repetes >= 3){
+            int longueur = (repetes > 258) ? 258 : (int) repetes;
+            ecritRepetition(bits, longueur);
+            repetes -= longueur;
+        }
+        while (repetes > 0){
+            ecritSymbole(bits, donnees[i]);
+            repetes--;
+        }
+        i = j;
+    }
+    ecritSymbole(bits, 256);
+    if (bits->nbReste > 0){
+        ecritBits(bits, 0, 8 - bits->nbReste);
+    }
+
+    uint32_t a = 1, b = 0;
+    for (size_t k = 0; k < n; k++){
+        a = (a + donnees[k]) % 65521;
+        b = (b + a) % 65521;
+    }
+    uint32_t adler = (b << 16) | a;
+    for (int k = 3; k >= 0; k--){
+        ajouteOctet(bits, (adler >> (8 * k)) & 0xff);
+    }
+}
+
+/**
+ * @brief Écrit un entier de 32 bits, poids fort en premier
+ */
+static void grandBoutiste(unsigned char *octets, uint32_t valeur){
+    octets[0] = valeur >> 24;
+    octets[1] = valeur >> 16;
+    octets[2] = valeur >> 8;
+    octets[3] = valeur;
+}
+
+/**
+ * @brief Écrit un morceau PNG (longueur, type, données, CRC)
+ */
+static int ecritMorceau(FILE *sortie, const char *type, const unsigned char *donnees, size_t n,
+                        const uint32_t *tableCRC){
+    unsigned char octets[4];
+
+    uint32_t crc = 0xffffffffu;
+    for (int k = 0; k < 4; k++){
+        crc = tableCRC[(crc ^ (unsigned char) type[k]) & 0xff] ^ (crc >> 8);
+    }
+    for (size_t k = 0; k < n; k++){
+        crc = tableCRC[(crc ^ donnees[k]) & 0xff] ^ (crc >> 8);
+    }
+
+    grandBoutiste(octets, (uint32_t) n);
+    int ok = fwrite(octets, 1, 4, sortie) == 4 && fwrite(type, 1, 4, sortie) == 4;
+    ok = ok && (n == 0 || fwrite(donnees, 1, n, sortie) == n);
+    grandBoutiste(octets, crc ^ 0xffffffffu);
+    return ok && fwrite(octets, 1, 4, sortie) == 4;
+}
+
+/**
+ * @brief Filtre une ligne de l'image : un octet de type puis la ligne filtrée par None, Sub ou
+ * Up, celui dont la somme des différences est la plus petite
+ */
+static void filtreLigne(const unsigned char *ligne, const unsigned char *precedente, int n, unsigned char *filtree){
+    long sommes[3] = {0, 0, 0};
+    for (int k = 0; k < n; k++){
+        unsigned char gauche = (k >= 3) ? ligne[k - 3] : 0;
+        unsigned char haut = precedente ? precedente[k] : 0;
+        sommes[0] += abs((signed char) ligne[k]);
+        sommes[1] += abs((signed char) (ligne[k] - gauche));
+        sommes[2] += abs((signed char) (ligne[k] - haut));
+    }
+
+    int type = 0;
+    for (int t = 1; t < 3; t++){
+        if (sommes[t] < sommes[type]){
+            type = t;
+        }
+    }
+
+    filtree[0] = type;
+    for (int k = 0; k < n; k++){
+        unsigned char gauche = (k >= 3) ? ligne[k - 3] : 0;
+        unsigned char haut = precedente ? precedente[k] : 0;
+        filtree[k + 1] = ligne[k] - ((type == 1) ? gauche : (type == 2) ? haut : 0);
+    }
+}
+
+int ecritPNG(const Image *image, const char *chemin){
+    uint32_t tableCRC[256];
+    for (uint32_t k = 0; k < 256; k++){
+        uint32_t c = k;
+        for (int i = 0; i < 8; i++){
+            c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        }
+        tableCRC[k] = c;
+    }
+
+    size_t n = (size_t) image->largeur * 3;
+    unsigned char *filtrees = (unsigned char *) malloc((n + 1) * image->hauteur);
+    if (!filtrees){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    for (int y = 0; y < image->hauteur; y++){
+        const unsigned char *ligne = image->pixels + y * n;
+        filtreLigne(ligne, y ? ligne - n : NULL, (int) n, filtrees + y * (n + 1));
+    }
+
+    Bits bits = {NULL, 0, 0, 0, 0};
+    compresse(&bits, filtrees, (n + 1) * image->hauteur);
+    free(filtrees);
+
+    FILE *sortie = fopen(chemin, "wb");
+    if (!sortie){
+        fprintf(stderr, "Impossible d'ouvrir %s\n", chemin);
+        free(bits.octets);
+        return 0;
+    }
+
+    // IHDR : dimensions, 8 bits par composante, RGB, sans entrelacement
+    static const unsigned char signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    unsigned char entete[13];
+    grandBoutiste(entete, image->largeur);
+    grandBoutiste(entete + 4, image->hauteur);
+    entete[8] = 8;
+    entete[9] = 2;
+    entete[10] = entete[11] = entete[12] = 0;
+
+    int ok = fwrite(signature, 1, 8, sortie) == 8;
+    ok = ok && ecritMorceau(sortie, "IHDR", entete, 13, tableCRC);
+    ok = ok && ecritMorceau(sortie, "IDAT", bits.octets, bits.nbOctet, tableCRC);
+    ok = ok && ecritMorceau(sortie, "IEND", NULL, 0, tableCRC);
+    ok = (fclose(sortie) == 0) && ok;
+    free(bits.octets);
+    if (!ok){
+        fprintf(stderr, "Erreur d'ecriture de %s\n", chemin);
+    }
+
+    return ok;
+}
+
+////////////////////////
+// Fonctions densités //
+////////////////////////
+
+void creeDensite(Densite *densite, int largeur, int hauteur){
+    densite->largeur = largeur;
+    densite->hauteur = hauteur;
+    densite->max = 0;
+    densite->comptes = (uint32_t *) calloc((size_t) largeur * hauteur + 1, sizeof(uint32_t));
+    if (!densite->comptes){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+}
+
+void libereDensite(Densite *densite){
+    free(densite->comptes);
+    densite->comptes = NULL;
+    densite->largeur = densite->hauteur = 0;
+    densite->max = 0;
+}
+
+/**
+ * @brief Compte une tranche de points dans son tampon
+ */
+static void compteTranche(void *arg){
+    TacheDensite *tache = (TacheDensite *) arg;
+    const double *x = tache->nuage->x;
+    const double *y = tache->nuage->y;
+    uint32_t *comptes = tache->comptes;
+    int largeur = tache->largeur;
+    int hauteur = tache->hauteur;
+
+    for (int i = tache->debut; i < tache->fin; i++){
+        double px = floor(tache->echelle * x[i] + tache->dx + 0.5);
+        double py = floor(tache->echelle * y[i] + tache->dy + 0.5);
+        if (px >= 0 && py >= 0 && px < largeur && py < hauteur){
+            comptes[(size_t) py * largeur + (size_t) px] += 1;
+        }
+    }
+}
+
+/**
+ * @brief Additionne une bande de pixels des tampons dans la carte et y cherche le plus grand compte
+ */
+static void additionneBande(void *arg){
+    TacheDensite *tache = (TacheDensite *) arg;
+    uint32_t max = 0;
+
+    for (int t = 0; t < tache->nbTampon; t++){
+        const uint32_t *tampon = tache->tampons[t];
+        for (int k = tache->debut; k < tache->fin; k++){
+            tache->comptes[k] += tampon[k];
+        }
+    }
+    for (int k = tache->debut; k < tache->fin; k++){
+        max = (tache->comptes[k] > max) ? tache->comptes[k] : max;
+    }
+    tache->max = max;
+}
+
+/**
+ * @brief Compte les points dans la carte avec un groupe de threads déjà créé
+ */
+static void compteDensite(PoolTaches *pool, Densite *densite, const NuagePoints *nuage, double echelle, double dx,
+                          double dy){
+    size_t nbPixel = (size_t) densite->largeur * densite->hauteur;
+    int nbPoint = nuage ? nuage->nbPoint : 0;
+    memset(densite->comptes, 0, nbPixel * sizeof(uint32_t));
+    densite->max = 0;
+
+    // Une tranche par ouvrier, si elle est assez grande et que les tampons privés tiennent
+    int nbTranche = nbOuvriers(pool);
+    if (nbTranche > nbPoint / DENSITE_TRANCHE){
+        nbTranche = nbPoint / DENSITE_TRANCHE;
+    }
+    if ((size_t) nbTranche * nbPixel * sizeof(uint32_t) > DENSITE_MEMOIRE){
+        nbTranche = (int) (DENSITE_MEMOIRE / (nbPixel * sizeof(uint32_t)));
+    }
+    if (nbTranche < 1){
+        nbTranche = 1;
+    }
+
+    TacheDensite *taches = (TacheDensite *) malloc(nbTranche * sizeof(TacheDensite));
+    uint32_t **tampons = (uint32_t **) malloc(nbTranche * sizeof(uint32_t *));
+    if (!taches || !tampons){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    // La première tranche compte directement dans la carte
+    GroupeTaches groupe;
+    initGroupe(&groupe);
+    for (int t = 0; t < nbTranche; t++){
+        TacheDensite *tache = taches + t;
+        tache->nuage = nuage;
+        tache->debut = (int) ((long long) nbPoint * t / nbTranche);
+        tache->fin = (int) ((long long) nbPoint * (t + 1) / nbTranche);
+        tache->echelle = echelle;
+        tache->dx = dx;
+        tache->dy = dy;
+        tache->largeur = densite->largeur;
+        tache->hauteur = densite->hauteur;
+        tache->comptes = t ? (uint32_t *) calloc(nbPixel + 1, sizeof(uint32_t)) : densite->comptes;
+        if (!tache->comptes){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        tampons[t] = tache->comptes;
+        lanceTache(pool, &groupe, compteTranche, tache);
+    }
+    attendsGroupe(pool, &groupe);
+
+    // Réduction par bandes de pixels, autant que de tranches
+    TacheDensite *bandes = (TacheDensite *) malloc(nbTranche * sizeof(TacheDensite));
+    if (!bandes){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    initGroupe(&groupe);
+    for (int b = 0; b < nbTranche; b++){
+        TacheDensite *bande = bandes + b;
+        bande->debut = (int) (nbPixel * b / nbTranche);
+        bande->fin = (int) (nbPixel * (b + 1) / nbTranche);
+        bande->comptes = densite->comptes;
+        bande->tampons = tampons + 1;
+        bande->nbTampon = nbTranche - 1;
+        lanceTache(pool, &groupe, additionneBande, bande);
+    }
+    attendsGroupe(pool, &groupe);
+
+    for (int b = 0; b < nbTranche; b++){
+        densite->max = (bandes[b].max > densite->max) ? bandes[b].max : densite->max;
+    }
+    for (int t = 1; t < nbTranche; t++){
+        free(tampons[t]);
+    }
+    free(bandes);
+    free(tampons);
+    free(taches);
+}
+
+void accumuleDensite(Densite *densite, const NuagePoints *nuage, double echelle, double dx, double dy, int nbThread){
+    if (nbThread <= 0){
+        nbThread = nbCoeurs();
+    }
+
+    PoolTaches *pool = creePoolTaches(nbThread);
+    if (!pool){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    compteDensite(pool, densite, nuage, echelle, dx, dy);
+    detruitPoolTaches(pool);
+}
+
+Couleur couleurDensite(const Densite *densite, int x, int y, Couleur fond, Couleur encre){
+    uint32_t compte = densite->comptes[(size_t) y * densite->largeur + x];
+    if (!compte){
+        return fond;
+    }
+
+    double opacite = DENSITE_OPACITE_MIN;
+    if (densite->max > 1){
+        opacite += (1.0 - DENSITE_OPACITE_MIN) * log((double) compte) / log((double) densite->max);
+    }
+
+    Couleur couleur;
+    couleur.r = (unsigned char) (fond.r + (encre.r - fond.r) * opacite + 0.5);
+    couleur.g = (unsigned char) (fond.g + (encre.g - fond.g) * opacite + 0.5);
+    couleur.b = (unsigned char) (fond.b + (encre.b - fond.b) * opacite + 0.5);
+    return couleur;
+}
+
+//////////////////////
+// Fonctions scènes //
+//////////////////////
+
+void initScene(Scene *scene){
+    static const Couleur rouge = {255, 0, 0};
+
+    scene->echelle = 1.0;
+    scene->dx = scene->dy = 0.0;
+    scene->fond = (Couleur) {255, 255, 255};
+    scene->nuage = NULL;
+    scene->rayonPoint = 3;
+    scene->couleurPoint = (Couleur) {0, 0, 0};
+    scene->densite = 0;
+    scene->couches = NULL;
+    scene->couleurs = &rouge;
+    scene->nbCouleur = 1;
+    scene->rayonSommet = 4;
+    scene->sommetsMin = 1;
+    scene->alphaArete = 80;
+    scene->alphaRemplissage = 64;
+}
+
+void cadreScene(Scene *scene, double xmin, double ymin, double xmax, double ymax, int largeur, int hauteur,
+                int marge){
+    double l = largeur - 2.0 * marge;
+    double h = hauteur - 2.0 * marge;
+    double echelle = 1.0;
+
+    if (xmax > xmin && ymax > ymin){
+        echelle = (l / (xmax - xmin) < h / (ymax - ymin)) ? l / (xmax - xmin) : h / (ymax - ymin);
+    }
+    else if (xmax > xmin){
+        echelle = l / (xmax - xmin);
+    }
+    else if (ymax > ymin){
+        echelle = h / (ymax - ymin);
+    }
+
+    scene->echelle = echelle;
+    scene->dx = (largeur - echelle * (xmin + xmax)) / 2;
+    scene->dy = (hauteur - echelle * (ymin + ymax)) / 2;
+}
+
+/**
+ * @brief Convertit une coordonnée en pixel, arrondie et bornée
+ */
+static int versPixel(double echelle, double decalage, double v){
+    double p = floor(echelle * v + decalage + 0.5);
+    if (!(p > -PIXEL_MAX)){
+        return -PIXEL_MAX;
+    }
+    if (p > PIXEL_MAX){
+        return PIXEL_MAX;
+    }
+    return (int) p;
+}
+
+/**
+ * @brief Convertit les couches en pixels et range les points par tuile, ou les compte dans la
+ * carte de densité
+ */
+static void prepareScene(Preparation *preparation, const Scene *scene, const Image *image, PoolTaches *pool){
+    preparation->scene = scene;
+
+    // Couches dessinées et leurs sommets
+    int nbCouche = 0;
+    int nbSommet = 0;
+    for (const ConvexHull *parcours = scene->couches; parcours; parcours = parcours->next){
+        if (parcours->curlen > 0 && parcours->curlen >= scene->sommetsMin){
+            nbCouche += 1;
+            nbSommet += parcours->curlen;
+        }
+    }
+
+    preparation->nbCouche = nbCouche;
+    preparation->debut = (int *) malloc((nbCouche + 1) * sizeof(int));
+    preparation->px = (int *) malloc((nbSommet + 1) * sizeof(int));
+    preparation->py = (int *) malloc((nbSommet + 1) * sizeof(int));
+    preparation->boites = (Zone *) malloc((nbCouche + 1) * sizeof(Zone));
+    preparation->couleurs = (Couleur *) malloc((nbCouche + 1) * sizeof(Couleur));
+    if (!preparation->debut || !preparation->px || !preparation->py || !preparation->boites || !preparation->couleurs){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    int c = 0;
+    int s = 0;
+    for (const ConvexHull *parcours = scene->couches; parcours; parcours = parcours->next){
+        if (parcours->curlen <= 0 || parcours->curlen < scene->sommetsMin){
+            continue;
+        }
+
+        Zone *boite = preparation->boites + c;
+        videZone(boite);
+        preparation->debut[c] = s;
+        preparation->couleurs[c] = scene->couleurs[parcours->numero % scene->nbCouleur];
+
+        const Vertex *anneau = parcours->anneau;
+        int v = parcours->pol;
+        do{
+            preparation->px[s] = versPixel(scene->echelle, scene->dx, anneau[v].p.x);
+            preparation->py[s] = versPixel(scene->echelle, scene->dy, anneau[v].p.y);
+            ajoutePointZone(boite, preparation->px[s], preparation->py[s], scene->rayonSommet);
+            s += 1;
+            v = anneau[v].next;
+        } while (v != parcours->pol);
+        c += 1;
+    }
+    preparation->debut[c] = s;
+
+    // Points : un disque est rangé dans chaque tuile qu'il touche (au plus quatre)
+    int nbTuileX = (image->largeur + RASTER_TUILE - 1) / RASTER_TUILE;
+    int nbTuileY = (image->hauteur + RASTER_TUILE - 1) / RASTER_TUILE;
+    int nbTuile = nbTuileX * nbTuileY;
+    preparation->nbTuileX = nbTuileX;
+    preparation->nbTuileY = nbTuileY;
+    preparation->debutTuile = (int *) calloc(nbTuile + 1, sizeof(int));
+    if (!preparation->debutTuile){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    int nbPoint = scene->nuage ? scene->nuage->nbPoint : 0;
+    int r = scene->rayonPoint;
+    preparation->densite.comptes = NULL;
+    if (scene->densite && nbPoint > 0){
+        creeDensite(&(preparation->densite), image->largeur, image->hauteur);
+        compteDensite(pool, &(preparation->densite), scene->nuage, scene->echelle, scene->dx, scene->dy);
+        nbPoint = 0;
+    }
+    for (int passe = 0; passe < 2; passe++){
+        for (int i = 0; i < nbPoint; i++){
+            int x = versPixel(scene->echelle, scene->dx, scene->nuage->x[i]);
+            int y = versPixel(scene->echelle, scene->dy, scene->nuage->y[i]);
+            if (x + r < 0 || y + r < 0 || x - r >= image->largeur || y - r >= image->hauteur){
+                continue;
+            }
+
+            int tx0 = (x - r > 0) ? (x - r) / RASTER_TUILE : 0;
+            int ty0 = (y - r > 0) ? (y - r) / RASTER_TUILE : 0;
+            int tx1 = (x + r < image->largeur) ? (x + r) / RASTER_TUILE : nbTuileX - 1;
+            int ty1 = (y + r < image->hauteur) ? (y + r) / RASTER_TUILE : nbTuileY - 1;
+            for (int ty = ty0; ty <= ty1; ty++){
+                for (int tx = tx0; tx <= tx1; tx++){
+                    int t = ty * nbTuileX + tx;
+                    // Première passe : le compte de chaque tuile ; seconde : le rangement
+                    if (passe == 0){
+                        preparation->debutTuile[t + 1] += 1;
+                    }
+                    else{
+                        int k = preparation->debutTuile[t]++;
+                        preparation->pointsTuiles[2 * k] = x;
+                        preparation->pointsTuiles[2 * k + 1] = y;
+                    }
+                }
+            }
+        }
+
+        if (passe == 0){
+            for (int t = 0; t < nbTuile; t++){
+                preparation->debutTuile[t + 1] += preparation->debutTuile[t];
+            }
+            size_t nbRange = preparation->debutTuile[nbTuile];
+            preparation->pointsTuiles = (int *) malloc((2 * nbRange + 1) * sizeof(int));
+            if (!preparation->pointsTuiles){
+                fprintf(stderr,"Plus de memoire ");
+                exit(-1);
+            }
+        }
+    }
+
+    // Le rangement a avancé chaque début jusqu'au début de la tuile suivante
+    for (int t = nbTuile; t > 0; t--){
+        preparation->debutTuile[t] = preparation->debutTuile[t - 1];
+    }
+    preparation->debutTuile[0] = 0;
+}
+
+/**
+ * @brief Libère une scène convertie en pixels
+ */
+static void liberePreparation(Preparation *preparation){
+    free(preparation->debut);
+    free(preparation->px);
+    free(preparation->py);
+    free(preparation->boites);
+    free(preparation->couleurs);
+    free(preparation->debutTuile);
+    free(preparation->pointsTuiles);
+    if (preparation->densite.comptes){
+        libereDensite(&(preparation->densite));
+    }
+}
+
+//////////////////////////
+// Fonctions primitives //
+//////////////////////////
+
+/**
+ * @brief Mélange une couleur à un pixel avec l'opacité alpha (0 à 255)
+ */
+static inline void melange(unsigned char *pixel, Couleur couleur, int alpha){
+    pixel[0] = (couleur.r * alpha + pixel[0] * (255 - alpha) + 127) / 255;
+    pixel[1] = (couleur.g * alpha + pixel[1] * (255 - alpha) + 127) / 255;
+    pixel[2] = (couleur.b * alpha + pixel[2] * (255 - alpha) + 127) / 255;
+}
+
+/**
+ * @brief Dessine la partie d'un disque opaque contenue dans la tuile
+ */
+static void disque(Image *image, const Zone *tuile, int cx, int cy, int r, Couleur couleur){
+    int y0 = (cy - r > tuile->y0) ? cy - r : tuile->y0;
+    int y1 = (cy + r + 1 < tuile->y1) ? cy + r + 1 : tuile->y1;
+    int x0 = (cx - r > tuile->x0) ? cx - r : tuile->x0;
+    int x1 = (cx + r + 1 < tuile->x1) ? cx + r + 1 : tuile->x1;
+
+    for (int y = y0; y < y1; y++){
+        unsigned char *ligne = image->pixels + ((size_t) y * image->largeur) * 3;
+        for (int x = x0; x < x1; x++){
+            if ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r){
+                ligne[3 * x] = couleur.r;
+                ligne[3 * x + 1] = couleur.g;
+                ligne[3 * x + 2] = couleur.b;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Dessine la partie d'un segment transparent contenue dans la tuile. Le pixel de chaque
+ * colonne (ou ligne, si le segment est plus haut que large) est calculé directement, comme le
+ * donnerait Bresenham depuis (x0, y0) : le tracé ne dépend pas du découpage en tuiles
+ */
+static void segment(Image *image, const Zone *tuile, int x0, int y0, int x1, int y1, Couleur couleur, int alpha){
+    Zone boite;
+    videZone(&boite);
+    ajoutePointZone(&boite, x0, y0, 0);
+    ajoutePointZone(&boite, x1, y1, 0);
+    if (!intersecteZones(&boite, tuile)){
+        return;
+    }
+
+    long long ax = llabs((long long) x1 - x0);
+    long long ay = llabs((long long) y1 - y0);
+    int sx = (x1 >= x0) ? 1 : -1;
+    int sy = (y1 >= y0) ? 1 : -1;
+
+    if (ax >= ay){
+        int debut = (boite.x0 > tuile->x0) ? boite.x0 : tuile->x0;
+        int fin = (boite.x1 < tuile->x1) ? boite.x1 : tuile->x1;
+        for (int x = debut; x < fin; x++){
+            long long i = (long long) (x - x0) * sx;
+            int y = y0 + sy * (int) (ax ? (2 * i * ay + ax) / (2 * ax) : 0);
+            if (y >= tuile->y0 && y < tuile->y1){
+                melange(image->pixels + ((size_t) y * image->largeur + x) * 3, couleur, alpha);
+            }
+        }
+    }
+    else{
+        int debut = (boite.y0 > tuile->y0) ? boite.y0 : tuile->y0;
+        int fin = (boite.y1 < tuile->y1) ? boite.y1 : tuile->y1;
+        for (int y = debut; y < fin; y++){
+            long long i = (long long) (y - y0) * sy;
+            int x = x0 + sx * (int) ((2 * i * ax + ay) / (2 * ay));
+            if (x >= tuile->x0 && x < tuile->x1){
+                melange(image->pixels + ((size_t) y * image->largeur + x) * 3, couleur, alpha);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Remplit la partie d'un polygone convexe transparent contenue dans la tuile : sur chaque
+ * ligne, les pixels entre l'arête gauche et l'arête droite
+ */
+static void remplitPolygone(Image *image, const Zone *tuile, const int *px, const int *py, int n, Couleur couleur,
+                            int alpha){
+    double gauche[RASTER_TUILE];
+    double droite[RASTER_TUILE];
+    int hauteur = tuile->y1 - tuile->y0;
+
+    for (int k = 0; k < hauteur; k++){
+        gauche[k] = HUGE_VAL;
+        droite[k] = -HUGE_VAL;
+    }
+
+    for (int i = 0; i < n; i++){
+        int j = (i + 1 < n) ? i + 1 : 0;
+        int ya = (py[i] < py[j]) ? py[i] : py[j];
+        int yb = (py[i] < py[j]) ? py[j] : py[i];
+        if (yb < tuile->y0 || ya >= tuile->y1){
+            continue;
+        }
+
+        int debut = (ya > tuile->y0) ? ya : tuile->y0;
+        int fin = (yb < tuile->y1 - 1) ? yb : tuile->y1 - 1;
+        for (int y = debut; y <= fin; y++){
+            // Une arête horizontale donne ses deux extrémités
+            double xa = (py[i] == py[j]) ? px[j] : px[i] + (double) (y - py[i]) * (px[j] - px[i]) / (py[j] - py[i]);
+            double xb = (py[i] == py[j]) ? px[i] : xa;
+            double *g = gauche + y - tuile->y0;
+            double *d = droite + y - tuile->y0;
+            *g = (xa < *g) ? xa : *g;
+            *g = (xb < *g) ? xb : *g;
+            *d = (xa > *d) ? xa : *d;
+            *d = (xb > *d) ? xb : *d;
+        }
+    }
+
+    for (int k = 0; k < hauteur; k++){
+        if (gauche[k] > droite[k]){
+            continue;
+        }
+        double g = ceil(gauche[k]);
+        double d = floor(droite[k]);
+        int x0 = (g > tuile->x0) ? (int) g : tuile->x0;
+        int x1 = (d < tuile->x1 - 1) ? (int) d : tuile->x1 - 1;
+
+        unsigned char *ligne = image->pixels + ((size_t) (tuile->y0 + k) * image->largeur) * 3;
+        for (int x = x0; x <= x1; x++){
+            melange(ligne + 3 * x, couleur, alpha);
+        }
+    }
+}
+
+//////////////////////
+// Fonctions tuiles //
+//////////////////////
+
+/**
+ * @brief Dessine une tuile : le fond, les points (ou la carte de densité), puis chaque couche comme dessineConvexe (les
+ * disques des deux extrémités et l'arête, pour chaque arête, puis le remplissage)
+ */
+static void dessineTuile(void *arg){
+    TacheTuile *tache = (TacheTuile *) arg;
+    const Preparation *preparation = tache->preparation;
+    const Scene *scene = preparation->scene;
+    Image *image = tache->image;
+    const Zone *tuile = &(tache->tuile);
+
+    const Densite *densite = &(preparation->densite);
+    for (int y = tuile->y0; y < tuile->y1; y++){
+        unsigned char *ligne = image->pixels + ((size_t) y * image->largeur) * 3;
+        for (int x = tuile->x0; x < tuile->x1; x++){
+            Couleur couleur = densite->comptes ? couleurDensite(densite, x, y, scene->fond, scene->couleurPoint)
+                                               : scene->fond;
+            ligne[3 * x] = couleur.r;
+            ligne[3 * x + 1] = couleur.g;
+            ligne[3 * x + 2] = couleur.b;
+        }
+    }
+
+    const int *points = preparation->pointsTuiles;
+    for (int k = preparation->debutTuile[tache->numero]; k < preparation->debutTuile[tache->numero + 1]; k++){
+        disque(image, tuile, points[2 * k], points[2 * k + 1], scene->rayonPoint, scene->couleurPoint);
+    }
+
+    for (int c = 0; c < preparation->nbCouche; c++){
+        if (!intersecteZones(preparation->boites + c, tuile)){
+            continue;
+        }
+
+        const int *px = preparation->px + preparation->debut[c];
+        const int *py = preparation->py + preparation->debut[c];
+        int n = preparation->debut[c + 1] - preparation->debut[c];
+        Couleur couleur = preparation->couleurs[c];
+
+        for (int i = 0; i < n; i++){
+            int j = (i + 1 < n) ? i + 1 : 0;
+            if (scene->rayonSommet > 0){
+                disque(image, tuile, px[i], py[i], scene->rayonSommet, couleur);
+                disque(image, tuile, px[j], py[j], scene->rayonSommet, couleur);
+            }
+            if (n >= 2){
+                segment(image, tuile, px[i], py[i], px[j], py[j], couleur, scene->alphaArete);
+            }
+        }
+
+        if (n >= 3){
+            remplitPolygone(image, tuile, px, py, n, couleur, scene->alphaRemplissage);
+        }
+    }
+}
+
+void rasteriseScene(Image *image, const Scene *scene, int nbThread){
+    if (image->largeur <= 0 || image->hauteur <= 0){
+        return;
+    }
+    if (nbThread <= 0){
+        nbThread = nbCoeurs();
+    }
+
+    PoolTaches *pool = creePoolTaches(nbThread);
+    if (!pool){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    Preparation preparation;
+    prepareScene(&preparation, scene, image, pool);
+
+    int nbTuile = preparation.nbTuileX * preparation.nbTuileY;
+    TacheTuile *taches = (TacheTuile *) malloc(nbTuile * sizeof(TacheTuile));
+    if (!taches){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    // Les tuiles ne se recouvrent pas : chaque tâche écrit ses propres pixels
+    GroupeTaches groupe;
+    initGroupe(&groupe);
+    for (int t = 0; t < nbTuile; t++){
+        TacheTuile *tache = taches + t;
+        tache->preparation = &preparation;
+        tache->image = image;
+        tache->numero = t;
+        tache->tuile.x0 = (t % preparation.nbTuileX) * RASTER_TUILE;
+        tache->tuile.y0 = (t / preparation.nbTuileX) * RASTER_TUILE;
+        tache->tuile.x1 = tache->tuile.x0 + RASTER_TUILE;
+        tache->tuile.y1 = tache->tuile.y0 + RASTER_TUILE;
+        if (tache->tuile.x1 > image->largeur){
+            tache->tuile.x1 = image->largeur;
+        }
+        if (tache->tuile.y1 > image->hauteur){
+            tache->tuile.y1 = image->hauteur;
+        }
+        lanceTache(pool, &groupe, dessineTuile, tache);
+    }
+    attendsGroupe(pool, &groupe);
+
+    detruitPoolTaches(pool);
+    free(taches);
+    liberePreparation(&preparation);
+}
@@ -0,0 +1,197 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stdint.h>
+
+#include "enveloppe.h"
+
+/*
+ * Dessin sans fenêtre : les points, les arêtes et les remplissages transparents des couches, tels
+ * que dessineConvexe les dessine, sont tracés dans une image en mémoire, puis écrits en PPM ou en
+ * PNG. L'image est découpée en tuiles de RASTER_TUILE pixels de côté, dessinées en parallèle par
+ * le groupe de threads à vol de tâches (taches.h) : chaque tuile applique toutes les primitives
+ * dans l'ordre, bornées à ses pixels, si bien que l'image ne dépend pas du nombre de threads.
+ * Pour des millions de points, une carte de densité (le nombre de points de chaque pixel, comptés
+ * en parallèle) remplace les disques : le dessin coûte alors la surface de l'image, quel que soit
+ * le nombre de points.
+ */
+
+#define RASTER_TUILE 128 /* côté des tuiles dessinées en parallèle, en pixels */
+#define DENSITE_SEUIL 200000 /* au-delà de ce nombre de points, une carte de densité remplace les disques */
+#define DENSITE_TRANCHE 65536 /* points minimum par tampon de la réduction parallèle */
+#define DENSITE_MEMOIRE (64 << 20) /* taille maximale des tampons privés de la réduction, en octets */
+#define DENSITE_OPACITE_MIN 0.35 /* opacité d'un pixel qui contient un seul point */
+
+/**
+ * @brief Couleur opaque
+ *
+ */
+typedef struct{
+    unsigned char r; /* rouge */
+    unsigned char g; /* vert */
+    unsigned char b; /* bleu */
+} Couleur;
+
+/**
+ * @brief Image en mémoire, trois octets (rouge, vert, bleu) par pixel, ligne par ligne
+ *
+ */
+typedef struct{
+    int largeur; /* largeur en pixels */
+    int hauteur; /* hauteur en pixels */
+    unsigned char *pixels; /* les pixels, de haut en bas */
+} Image;
+
+/**
+ * @brief Nombre de points tombés dans chaque pixel d'une image
+ *
+ */
+typedef struct{
+    int largeur; /* largeur en pixels */
+    int hauteur; /* hauteur en pixels */
+    uint32_t *comptes; /* points de chaque pixel, ligne par ligne */
+    uint32_t max; /* le plus grand compte */
+} Densite;
+
+/**
+ * @brief Ce qu'il faut dessiner, et comment. Un point (x, y) est dessiné au pixel
+ * (echelle * x + dx, echelle * y + dy)
+ *
+ */
+typedef struct{
+    double echelle; /* facteur des coordonnées */
+    double dx; /* décalage des abscisses */
+    double dy; /* décalage des ordonnées */
+    Couleur fond; /* couleur du fond */
+    const NuagePoints *nuage; /* points dessinés (NULL: aucun) */
+    int rayonPoint; /* rayon du disque d'un point */
+    Couleur couleurPoint; /* couleur des points */
+    int densite; /* 1 pour dessiner les points en carte de densité plutôt qu'en disques */
+    const ConvexHull *couches; /* première couche dessinée, suivie par next (NULL: aucune) */
+    const Couleur *couleurs; /* la couche numéro k a la couleur couleurs[k % nbCouleur] */
+    int nbCouleur; /* nombre de couleurs */
+    int rayonSommet; /* rayon des disques opaques aux sommets (0: aucun) */
+    int sommetsMin; /* les couches de moins de sommets ne sont pas dessinées */
+    unsigned char alphaArete; /* opacité des arêtes */
+    unsigned char alphaRemplissage; /* opacité des remplissages */
+} Scene;
+
+/**
+ * @brief Les couleurs des couches d'env_convexes_p2
+ */
+extern const Couleur couleursCouches[];
+extern const int nbCouleursCouches;
+
+//////////////////////
+// Fonctions images //
+//////////////////////
+
+/**
+ * @brief Alloue une image
+ *
+ * @param image L'image à préparer
+ * @param largeur Largeur en pixels
+ * @param hauteur Hauteur en pixels
+ */
+void creeImage(Image *image, int largeur, int hauteur);
+
+/**
+ * @brief Libère les pixels d'une image
+ */
+void libereImage(Image *image);
+
+/**
+ * @brief Écrit une image au format PPM binaire (P6)
+ *
+ * @return 1 si l'image a été écrite, 0 sinon
+ */
+int ecritPPM(const Image *image, const char *chemin);
+
+/**
+ * @brief Écrit une image au format PNG, sans bibliothèque : chaque ligne est filtrée (None, Sub
+ * ou Up, la plus petite) et les répétitions d'octets sont codées par un bloc deflate à codes fixes
+ *
+ * @return 1 si l'image a été écrite, 0 sinon
+ */
+int ecritPNG(const Image *image, const char *chemin);
+
+/**
+ * @brief Écrit une image en PNG si le chemin finit par ".png", en PPM sinon
+ *
+ * @return 1 si l'image a été écrite, 0 sinon
+ */
+int ecritImage(const Image *image, const char *chemin);
+
+////////////////////////
+// Fonctions densités //
+////////////////////////
+
+/**
+ * @brief Alloue une carte de densité vide
+ */
+void creeDensite(Densite *densite, int largeur, int hauteur);
+
+/**
+ * @brief Libère une carte de densité
+ */
+void libereDensite(Densite *densite);
+
+/**
+ * @brief Compte les points d'un nuage dans chaque pixel, le point (x, y) tombant dans le pixel
+ * (echelle * x + dx, echelle * y + dy) arrondi. Les points sont répartis en tranches comptées
+ * par des threads dans des tampons privés, puis les tampons sont additionnés par bandes de
+ * lignes : le temps est en O(n / threads + pixels)
+ *
+ * @param densite La carte, remise à zéro avant le comptage
+ * @param nuage Le nuage des points
+ * @param echelle Facteur des coordonnées
+ * @param dx Décalage des abscisses
+ * @param dy Décalage des ordonnées
+ * @param nbThread Nombre de threads (0: un par processeur)
+ */
+void accumuleDensite(Densite *densite, const NuagePoints *nuage, double echelle, double dx, double dy, int nbThread);
+
+/**
+ * @brief Renvoie la couleur d'un pixel de la carte : le fond s'il est vide, sinon un mélange
+ * du fond et de l'encre dont l'opacité croît avec le logarithme du compte, de
+ * DENSITE_OPACITE_MIN pour un point à 1 pour le plus grand compte
+ */
+Couleur couleurDensite(const Densite *densite, int x, int y, Couleur fond, Couleur encre);
+
+//////////////////////
+// Fonctions scènes //
+//////////////////////
+
+/**
+ * @brief Prépare une scène vide dans le style d'env_convexes_p1 : fond blanc, points noirs de
+ * rayon 3 (en disques, la carte de densité étant à demander), couches rouges avec des sommets de
+ * rayon 4, arêtes d'opacité 80 et remplissages d'opacité 64, sans changement de coordonnées
+ */
+void initScene(Scene *scene);
+
+/**
+ * @brief Choisit l'échelle et le décalage d'une scène pour qu'une boîte tienne dans l'image,
+ * centrée, à marge pixels des bords
+ *
+ * @param scene La scène
+ * @param xmin Boîte à faire tenir
+ * @param ymin
+ * @param xmax
+ * @param ymax
+ * @param largeur Largeur de l'image
+ * @param hauteur Hauteur de l'image
+ * @param marge Marge en pixels
+ */
+void cadreScene(Scene *scene, double xmin, double ymin, double xmax, double ymax, int largeur, int hauteur,
+                int marge);
+
+/**
+ * @brief Dessine une scène dans une image, par tuiles
+ *
+ * @param image L'image, entièrement redessinée
+ * @param scene La scène
+ * @param nbThread Nombre de threads (0: un par processeur)
+ */
+void rasteriseScene(Image *image, const Scene *scene, int nbThread);
+
+#endif
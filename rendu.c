@@ -0,0 +1,219 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "rendu.h"
+
+////////////////////
+// Fonctions zone //
+////////////////////
+
+void videZone(Zone *zone){
+    zone->x0 = zone->y0 = 0;
+    zone->x1 = zone->y1 = 0;
+}
+
+void uneZones(Zone *zone, const Zone *autre){
+    if (zoneVide(autre)){
+        return;
+    }
+    if (zoneVide(zone)){
+        *zone = *autre;
+        return;
+    }
+
+    if (autre->x0 < zone->x0){
+        zone->x0 = autre->x0;
+    }
+    if (autre->y0 < zone->y0){
+        zone->y0 = autre->y0;
+    }
+    if (autre->x1 > zone->x1){
+        zone->x1 = autre->x1;
+    }
+    if (autre->y1 > zone->y1){
+        zone->y1 = autre->y1;
+    }
+}
+
+void ajoutePointZone(Zone *zone, double x, double y, int marge){
+    Zone disque;
+    disque.x0 = (int) floor(x) - marge;
+    disque.y0 = (int) floor(y) - marge;
+    disque.x1 = (int) ceil(x) + marge + 1;
+    disque.y1 = (int) ceil(y) + marge + 1;
+    uneZones(zone, &disque);
+}
+
+int intersecteZones(const Zone *a, const Zone *b){
+    return !zoneVide(a) && !zoneVide(b) && a->x0 < b->x1 && b->x0 < a->x1 && a->y0 < b->y1 && b->y0 < a->y1;
+}
+
+/**
+ * @brief Renvoie 1 si la zone a contient la zone b
+ */
+static int contientZone(const Zone *a, const Zone *b){
+    return a->x0 <= b->x0 && a->y0 <= b->y0 && b->x1 <= a->x1 && b->y1 <= a->y1;
+}
+
+void boiteEnveloppe(const ConvexHull *enveloppe, int marge, Zone *boite){
+    videZone(boite);
+    if (enveloppe->curlen <= 0){
+        return;
+    }
+
+    const Vertex *anneau = enveloppe->anneau;
+    double xMin = anneau[enveloppe->pol].p.x, xMax = xMin;
+    double yMin = anneau[enveloppe->pol].p.y, yMax = yMin;
+
+    int v = enveloppe->pol;
+    do{
+        Point P = anneau[v].p;
+        if (P.x < xMin){
+            xMin = P.x;
+        }
+        if (P.x > xMax){
+            xMax = P.x;
+        }
+        if (P.y < yMin){
+            yMin = P.y;
+        }
+        if (P.y > yMax){
+            yMax = P.y;
+        }
+        v = anneau[v].next;
+    } while (v != enveloppe->pol);
+
+    ajoutePointZone(boite, xMin, yMin, marge);
+    ajoutePointZone(boite, xMax, yMax, marge);
+}
+
+/////////////////////////
+// Fonctions affichage //
+/////////////////////////
+
+void initAffichage(Affichage *affichage, int largeur, int hauteur, int marge){
+    affichage->largeur = largeur;
+    affichage->hauteur = hauteur;
+    affichage->marge = marge;
+    affichage->nbPoint = 0;
+    affichage->version = 0;
+    affichage->boites = NULL;
+    affichage->nbBoite = 0;
+    affichage->capacite = 0;
+}
+
+/**
+ * @brief Agrandit le tableau des boîtes pour qu'il contienne au moins nb boîtes
+ */
+static void reserveBoites(Affichage *affichage, int nb){
+    if (nb <= affichage->capacite){
+        return;
+    }
+
+    int capacite = affichage->capacite ? 2 * affichage->capacite : 16;
+    while (capacite < nb){
+        capacite *= 2;
+    }
+
+    Zone *boites = (Zone *) realloc(affichage->boites, capacite * sizeof(Zone));
+    if (!boites){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    affichage->boites = boites;
+    affichage->capacite = capacite;
+}
+
+int zoneModifiee(Affichage *affichage, const Instantane *instantane, Zone *zone){
+    videZone(zone);
+
+    // Les points de l'instantané commencent à premierPoint, déjà dessinés ou non
+    int premier = (affichage->nbPoint > instantane->premierPoint) ? affichage->nbPoint : instantane->premierPoint;
+    for (int i = premier; i < instantane->nbPoint; i++){
+        ajoutePointZone(zone, instantane->x[i - instantane->premierPoint], instantane->y[i - instantane->premierPoint],
+                        affichage->marge);
+    }
+    if (instantane->nbPoint > affichage->nbPoint){
+        affichage->nbPoint = instantane->nbPoint;
+    }
+
+    // Une couche modifiée est effacée de son ancienne boîte et redessinée dans la nouvelle
+    int rang = 0;
+    for (const ConvexHull *parcours = premiereCouche(instantane); parcours; parcours = parcours->next, rang++){
+        reserveBoites(affichage, rang + 1);
+        Zone *boite = affichage->boites + rang;
+
+        if (rang >= affichage->nbBoite || parcours->modification > affichage->version){
+            if (rang < affichage->nbBoite){
+                uneZones(zone, boite);
+            }
+            boiteEnveloppe(parcours, affichage->marge, boite);
+            uneZones(zone, boite);
+        }
+    }
+    for (int r = rang; r < affichage->nbBoite; r++){
+        uneZones(zone, affichage->boites + r);
+    }
+    affichage->nbBoite = rang;
+    affichage->version = instantane->version;
+
+    // Une couche qui coupe la zone y est redessinée en entier : la zone doit la contenir
+    int agrandie;
+    do{
+        agrandie = 0;
+        for (int r = 0; r < affichage->nbBoite; r++){
+            const Zone *boite = affichage->boites + r;
+            if (intersecteZones(zone, boite) && !contientZone(zone, boite)){
+                uneZones(zone, boite);
+                agrandie = 1;
+            }
+        }
+    } while (agrandie);
+
+    if (zone->x0 < 0){
+        zone->x0 = 0;
+    }
+    if (zone->y0 < 0){
+        zone->y0 = 0;
+    }
+    if (zone->x1 > affichage->largeur){
+        zone->x1 = affichage->largeur;
+    }
+    if (zone->y1 > affichage->hauteur){
+        zone->y1 = affichage->hauteur;
+    }
+
+    return !zoneVide(zone);
+}
+
+const Zone *boiteCouche(const Affichage *affichage, int rang){
+    return affichage->boites + rang;
+}
+
+void libereAffichage(Affichage *affichage){
+    free(affichage->boites);
+    affichage->boites = NULL;
+    affichage->nbBoite = 0;
+    affichage->capacite = 0;
+}
+
+///////////////////////
+// Fonctions cadence //
+///////////////////////
+
+void initCadence(Cadence *cadence, int imagesParSeconde){
+    cadence->intervalle = (imagesParSeconde > 0) ? 1000000000u / imagesParSeconde : 0;
+    cadence->prochaine = 0;
+}
+
+int imageDue(Cadence *cadence){
+    uint64_t maintenant = horlogeLatence();
+
+    if (maintenant < cadence->prochaine){
+        return 0;
+    }
+
+    cadence->prochaine = maintenant + cadence->intervalle;
+    return 1;
+}
@@ -0,0 +1,154 @@
+#ifndef RENDU_H
+#define RENDU_H
+
+#include <stdint.h>
+
+#include "enveloppe.h"
+#include "instantane.h"
+
+/*
+ * Affichage retenu, sans dépendance à MLV : au lieu d'effacer la fenêtre et de tout redessiner
+ * à chaque point, l'affichage se souvient de ce qu'il a dessiné (les points, et la boîte de
+ * chaque couche) et ne redessine que la zone des couches modifiées depuis la dernière image,
+ * d'après les dates de modification données par le moteur et recopiées dans les instantanés. Les couches sont remplies en
+ * transparence : une couche qui déborde de la zone l'agrandit, pour qu'aucun remplissage ne soit
+ * appliqué deux fois. Une cadence limite le nombre d'images par seconde, pour qu'une image
+ * regroupe toutes les insertions faites depuis la précédente.
+ */
+
+#define IMAGES_PAR_SECONDE 60 /* cadence par défaut de l'affichage */
+
+/**
+ * @brief Rectangle de pixels [x0, x1[ x [y0, y1[, vide si x0 >= x1 ou y0 >= y1
+ *
+ */
+typedef struct{
+    int x0; /* première colonne */
+    int y0; /* première ligne */
+    int x1; /* colonne suivant la dernière */
+    int y1; /* ligne suivant la dernière */
+} Zone;
+
+/**
+ * @brief Limite du nombre d'images par seconde
+ *
+ */
+typedef struct{
+    uint64_t intervalle; /* durée minimale entre deux images, en nanosecondes */
+    uint64_t prochaine; /* heure à partir de laquelle l'image suivante est due */
+} Cadence;
+
+/**
+ * @brief Ce qui est à l'écran : les points déjà dessinés et la boîte de chaque couche
+ *
+ */
+typedef struct{
+    int largeur; /* largeur de la fenêtre */
+    int hauteur; /* hauteur de la fenêtre */
+    int marge; /* pixels dessinés autour d'un sommet ou d'un point (rayon de son disque) */
+    int nbPoint; /* points du nuage déjà dessinés */
+    unsigned long version; /* version du moteur de l'instantané de la dernière image */
+    Zone *boites; /* boîte de chaque couche dans la dernière image, de l'extérieure vers l'intérieure */
+    int nbBoite; /* nombre de couches de la dernière image */
+    int capacite; /* taille allouée de boites */
+} Affichage;
+
+////////////////////
+// Fonctions zone //
+////////////////////
+
+/**
+ * @brief Renvoie 1 si la zone est vide
+ */
+static inline int zoneVide(const Zone *zone){
+    return zone->x0 >= zone->x1 || zone->y0 >= zone->y1;
+}
+
+/**
+ * @brief Vide une zone
+ */
+void videZone(Zone *zone);
+
+/**
+ * @brief Agrandit une zone pour qu'elle contienne une autre
+ */
+void uneZones(Zone *zone, const Zone *autre);
+
+/**
+ * @brief Agrandit une zone pour qu'elle contienne le disque de rayon marge centré sur un point
+ */
+void ajoutePointZone(Zone *zone, double x, double y, int marge);
+
+/**
+ * @brief Renvoie 1 si deux zones ont un pixel commun
+ */
+int intersecteZones(const Zone *a, const Zone *b);
+
+/**
+ * @brief Calcule la boîte des sommets d'une enveloppe, élargie de marge pixels
+ *
+ * @param enveloppe L'enveloppe
+ * @param marge Rayon des disques dessinés aux sommets
+ * @param boite La zone calculée (vide si l'enveloppe est vide)
+ */
+void boiteEnveloppe(const ConvexHull *enveloppe, int marge, Zone *boite);
+
+/////////////////////////
+// Fonctions affichage //
+/////////////////////////
+
+/**
+ * @brief Prépare l'affichage d'une fenêtre vide
+ *
+ * @param affichage L'affichage
+ * @param largeur Largeur de la fenêtre
+ * @param hauteur Hauteur de la fenêtre
+ * @param marge Rayon des disques dessinés aux sommets et aux points
+ */
+void initAffichage(Affichage *affichage, int largeur, int hauteur, int marge);
+
+/**
+ * @brief Calcule la zone de la fenêtre à redessiner pour passer de la dernière image à un
+ * instantané : les anciennes et nouvelles boîtes des couches modifiées, celles des couches
+ * disparues, les points ajoutés, puis toute couche qui déborde de la zone. L'affichage est mis
+ * à jour comme si l'image était dessinée ; nbPoint est à lire avant l'appel pour connaître les
+ * points à ajouter
+ *
+ * @param affichage L'affichage
+ * @param instantane L'instantané à dessiner
+ * @param zone La zone à redessiner, bornée à la fenêtre
+ * @return 1 si la zone n'est pas vide
+ */
+int zoneModifiee(Affichage *affichage, const Instantane *instantane, Zone *zone);
+
+/**
+ * @brief Renvoie la boîte d'une couche dans la dernière image
+ *
+ * @param affichage L'affichage
+ * @param rang Rang de la couche (0: extérieure)
+ */
+const Zone *boiteCouche(const Affichage *affichage, int rang);
+
+/**
+ * @brief Libère les boîtes de l'affichage
+ */
+void libereAffichage(Affichage *affichage);
+
+///////////////////////
+// Fonctions cadence //
+///////////////////////
+
+/**
+ * @brief Prépare une cadence dont la première image est due tout de suite
+ *
+ * @param cadence La cadence
+ * @param imagesParSeconde Nombre maximal d'images par seconde (0: pas de limite)
+ */
+void initCadence(Cadence *cadence, int imagesParSeconde);
+
+/**
+ * @brief Renvoie 1 si une image est due, et repousse alors la suivante d'un intervalle
+ */
+int imageDue(Cadence *cadence);
+
+#endif
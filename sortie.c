@@ -0,0 +1,294 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdarg.h>
+
+#include "sortie.h"
+
+#define ENTIER_MAX 9007199254740992.0 /* 2^53 : au-delà, un double n'est plus codé en écarts entiers */
+#define LIGNE_MAX 128 /* place gardée libre dans le tampon avant une ligne de texte */
+
+/**
+ * @brief Tampon d'écriture : les octets sont accumulés puis écrits d'un coup
+ *
+ */
+typedef struct{
+    FILE *fichier; /* le fichier écrit */
+    int nb; /* octets en attente */
+    int erreur; /* 1 si une écriture a échoué */
+    unsigned char octets[TAMPON_SORTIE];
+} Tampon;
+
+//////////////////////
+// Fonctions tampon //
+//////////////////////
+
+static Tampon *creeTampon(FILE *fichier){
+    Tampon *tampon = (Tampon *) malloc(sizeof(Tampon));
+    if (!tampon){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    tampon->fichier = fichier;
+    tampon->nb = 0;
+    tampon->erreur = 0;
+    return tampon;
+}
+
+static void videTampon(Tampon *tampon){
+    if (tampon->nb > 0 && fwrite(tampon->octets, 1, tampon->nb, tampon->fichier) != (size_t) tampon->nb){
+        tampon->erreur = 1;
+    }
+    tampon->nb = 0;
+}
+
+static void ecritOctets(Tampon *tampon, const void *octets, int n){
+    if (tampon->nb + n > TAMPON_SORTIE){
+        videTampon(tampon);
+    }
+    memcpy(tampon->octets + tampon->nb, octets, n);
+    tampon->nb += n;
+}
+
+static void ecritVarint(Tampon *tampon, uint64_t v){
+    if (tampon->nb + 10 > TAMPON_SORTIE){
+        videTampon(tampon);
+    }
+    while (v >= 0x80){
+        tampon->octets[tampon->nb++] = (unsigned char) (v | 0x80);
+        v >>= 7;
+    }
+    tampon->octets[tampon->nb++] = (unsigned char) v;
+}
+
+/**
+ * @brief Écrit un écart signé en zigzag varint
+ */
+static void ecritEcart(Tampon *tampon, int64_t d){
+    ecritVarint(tampon, ((uint64_t) d << 1) ^ (uint64_t) (d >> 63));
+}
+
+/**
+ * @brief Écrit une ligne de texte au format de printf (au plus LIGNE_MAX octets)
+ */
+static void ecritTexte(Tampon *tampon, const char *format, ...){
+    if (TAMPON_SORTIE - tampon->nb < LIGNE_MAX){
+        videTampon(tampon);
+    }
+
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf((char *) tampon->octets + tampon->nb, TAMPON_SORTIE - tampon->nb, format, args);
+    va_end(args);
+
+    if (n > 0){
+        tampon->nb += n;
+    }
+}
+
+/**
+ * @brief Écrit les octets en attente et libère le tampon
+ *
+ * @return 1 si toutes les écritures ont réussi
+ */
+static int fermeTampon(Tampon *tampon){
+    videTampon(tampon);
+    if (fflush(tampon->fichier) != 0){
+        tampon->erreur = 1;
+    }
+
+    int ok = !tampon->erreur;
+    free(tampon);
+    return ok;
+}
+
+//////////////////////////////
+// Fonctions format binaire //
+//////////////////////////////
+
+/**
+ * @brief Renvoie 1 si toutes les coordonnées de l'enveloppe sont des entiers codables en écarts
+ */
+static int coordonneesEntieres(const ConvexHull *enveloppe){
+    int v = enveloppe->pol;
+    for (int i = 0; i < enveloppe->curlen; i++){
+        Point p = enveloppe->anneau[v].p;
+        if (!(fabs(p.x) <= ENTIER_MAX && fabs(p.y) <= ENTIER_MAX) || p.x != (int64_t) p.x || p.y != (int64_t) p.y){
+            return 0;
+        }
+        v = enveloppe->anneau[v].next;
+    }
+    return 1;
+}
+
+int ecritCouchesBinaires(FILE *fichier, const ConvexHull *premiere){
+    Tampon *tampon = creeTampon(fichier);
+
+    int nbCouche = 0;
+    for (const ConvexHull *parcours = premiere; parcours; parcours = parcours->next){
+        nbCouche += 1;
+    }
+
+    char magie[8] = SORTIE_MAGIE;
+    ecritOctets(tampon, magie, sizeof magie);
+    ecritVarint(tampon, nbCouche);
+
+    for (const ConvexHull *parcours = premiere; parcours; parcours = parcours->next){
+        int nbSommet = (parcours->pol >= 0) ? parcours->curlen : 0;
+        unsigned char codage = (nbSommet == 0 || coordonneesEntieres(parcours)) ? CODAGE_ENTIER : CODAGE_DOUBLE;
+
+        ecritVarint(tampon, parcours->numero);
+        ecritVarint(tampon, nbSommet);
+        ecritOctets(tampon, &codage, 1);
+
+        int64_t xPrec = 0;
+        int64_t yPrec = 0;
+        int v = parcours->pol;
+        for (int i = 0; i < nbSommet; i++){
+            Point p = parcours->anneau[v].p;
+            if (codage == CODAGE_ENTIER){
+                ecritEcart(tampon, (int64_t) p.x - xPrec);
+                ecritEcart(tampon, (int64_t) p.y - yPrec);
+                xPrec = (int64_t) p.x;
+                yPrec = (int64_t) p.y;
+            }
+            else{
+                ecritOctets(tampon, &(p.x), sizeof(double));
+                ecritOctets(tampon, &(p.y), sizeof(double));
+            }
+            v = parcours->anneau[v].next;
+        }
+    }
+
+    return fermeTampon(tampon);
+}
+
+/**
+ * @brief Lit un varint
+ *
+ * @return 1 si la lecture a réussi
+ */
+static int litVarint(FILE *fichier, uint64_t *v){
+    *v = 0;
+    for (int decalage = 0; decalage < 64; decalage += 7){
+        int c = getc(fichier);
+        if (c == EOF){
+            return 0;
+        }
+        *v |= (uint64_t) (c & 0x7f) << decalage;
+        if (!(c & 0x80)){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int litEcart(FILE *fichier, int64_t *d){
+    uint64_t v;
+    if (!litVarint(fichier, &v)){
+        return 0;
+    }
+    *d = (int64_t) (v >> 1) ^ -(int64_t) (v & 1);
+    return 1;
+}
+
+int litCouchesBinaires(FILE *fichier, NuagePoints *sommets, int **tailles){
+    char magie[8];
+    uint64_t nbCouche;
+
+    *tailles = NULL;
+    if (fread(magie, 1, sizeof magie, fichier) != sizeof magie || memcmp(magie, SORTIE_MAGIE, sizeof magie) != 0
+        || !litVarint(fichier, &nbCouche) || nbCouche > INT32_MAX){
+        return -1;
+    }
+
+    *tailles = (int *) malloc((nbCouche + 1) * sizeof(int));
+    if (!*tailles){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    for (uint64_t c = 0; c < nbCouche; c++){
+        uint64_t numero, nbSommet;
+        int codage = EOF;
+        if (!litVarint(fichier, &numero) || !litVarint(fichier, &nbSommet) || nbSommet > INT32_MAX
+            || ((codage = getc(fichier)) != CODAGE_ENTIER && codage != CODAGE_DOUBLE)){
+            free(*tailles);
+            *tailles = NULL;
+            return -1;
+        }
+        (*tailles)[c] = (int) nbSommet;
+
+        int64_t x = 0;
+        int64_t y = 0;
+        for (uint64_t i = 0; i < nbSommet; i++){
+            Point p;
+            int ok;
+            if (codage == CODAGE_ENTIER){
+                int64_t dx, dy;
+                ok = litEcart(fichier, &dx) && litEcart(fichier, &dy);
+                x += dx;
+                y += dy;
+                p.x = (double) x;
+                p.y = (double) y;
+            }
+            else{
+                ok = fread(&(p.x), sizeof(double), 1, fichier) == 1 && fread(&(p.y), sizeof(double), 1, fichier) == 1;
+            }
+            if (!ok){
+                free(*tailles);
+                *tailles = NULL;
+                return -1;
+            }
+            ajoutePoint(sommets, p);
+        }
+    }
+
+    return (int) nbCouche;
+}
+
+////////////////////////////
+// Fonctions format texte //
+////////////////////////////
+
+int ecritCouchesTexte(FILE *fichier, const ConvexHull *premiere, int json){
+    Tampon *tampon = creeTampon(fichier);
+
+    if (json){
+        ecritTexte(tampon, "{\"couches\": [");
+    }
+
+    for (const ConvexHull *parcours = premiere; parcours; parcours = parcours->next){
+        int nbSommet = (parcours->pol >= 0) ? parcours->curlen : 0;
+
+        if (json){
+            ecritTexte(tampon, "%s\n  {\"numero\": %d, \"sommets\": [", (parcours == premiere) ? "" : ",", parcours->numero);
+        }
+        else{
+            ecritTexte(tampon, "# couche %d : %d sommets\n", parcours->numero, nbSommet);
+        }
+
+        int v = parcours->pol;
+        for (int i = 0; i < nbSommet; i++){
+            Point p = parcours->anneau[v].p;
+            if (json){
+                ecritTexte(tampon, "%s[%.17g, %.17g]", i ? ", " : "", p.x, p.y);
+            }
+            else{
+                ecritTexte(tampon, "%.17g %.17g\n", p.x, p.y);
+            }
+            v = parcours->anneau[v].next;
+        }
+
+        if (json){
+            ecritTexte(tampon, "]}");
+        }
+    }
+
+    if (json){
+        ecritTexte(tampon, "\n]}\n");
+    }
+
+    return fermeTampon(tampon);
+}
@@ -0,0 +1,59 @@
+#ifndef SORTIE_H
+#define SORTIE_H
+
+#include <stdio.h>
+
+#include "enveloppe.h"
+
+/*
+ * Écriture des enveloppes (une seule, ou toutes les couches d'une liste) :
+ * - format binaire compact : la signature SORTIE_MAGIE, le nombre de couches, puis pour chaque
+ *   couche un en-tête (numéro, nombre de sommets, codage) et ses sommets dans l'ordre du polygone.
+ *   Les entiers sont des varint (7 bits par octet, poids faibles d'abord). Une couche dont toutes
+ *   les coordonnées sont entières (les pixels de la fenêtre) est codée par les écarts d'un sommet
+ *   au précédent, en zigzag (0, -1, 1, -2... deviennent 0, 1, 2, 3...) : le plus souvent un ou
+ *   deux octets par coordonnée. Les autres couches gardent leurs doubles, sur 8 octets ;
+ * - format texte ou JSON, pour la mise au point.
+ * Les écritures passent par un tampon de TAMPON_SORTIE octets.
+ */
+
+#define SORTIE_MAGIE "ENVCOU1" /* les 8 premiers octets du format binaire, '\0' compris */
+#define TAMPON_SORTIE 65536 /* taille du tampon d'écriture */
+
+/* Codage des sommets d'une couche */
+#define CODAGE_ENTIER 1 /* écarts entiers en zigzag varint */
+#define CODAGE_DOUBLE 2 /* doubles bruts, dans l'ordre des octets de la machine */
+
+/**
+ * @brief Écrit au format binaire l'enveloppe donnée et toutes les suivantes de sa liste
+ *
+ * @param fichier Le fichier écrit
+ * @param premiere La première enveloppe (NULL: aucune)
+ * @return 1 si tout a été écrit, 0 en cas d'erreur d'écriture
+ */
+int ecritCouchesBinaires(FILE *fichier, const ConvexHull *premiere);
+
+/**
+ * @brief Écrit en texte l'enveloppe donnée et toutes les suivantes de sa liste : une ligne
+ * "# couche numéro : n sommets", puis un sommet "x y" par ligne ; ou bien un document JSON
+ * {"couches": [{"numero": 0, "sommets": [[x, y], ...]}, ...]}
+ *
+ * @param fichier Le fichier écrit
+ * @param premiere La première enveloppe (NULL: aucune)
+ * @param json 1 pour le format JSON
+ * @return 1 si tout a été écrit, 0 en cas d'erreur d'écriture
+ */
+int ecritCouchesTexte(FILE *fichier, const ConvexHull *premiere, int json);
+
+/**
+ * @brief Relit un fichier écrit par ecritCouchesBinaires
+ *
+ * @param fichier Le fichier lu
+ * @param sommets Nuage où ajouter les sommets de toutes les couches, à la suite
+ * @param tailles Adresse où ranger le tableau alloué des nombres de sommets de chaque couche
+ * (à libérer avec free)
+ * @return Le nombre de couches, -1 si le fichier n'est pas valide
+ */
+int litCouchesBinaires(FILE *fichier, NuagePoints *sommets, int **tailles);
+
+#endif
@@ -0,0 +1,1029 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "statique.h"
+#include "filtre.h"
+#include "parallele.h"
+
+/**
+ * @brief Copie contiguë d'un point et son indice dans le nuage, pour le tri
+ *
+ */
+typedef struct{
+    Point p; /* les coordonnées du point */
+    int s; /* l'indice du point dans le nuage */
+} PointTrie;
+
+/**
+ * @brief Renvoie 1 si A précède strictement B dans l'ordre (x, y)
+ */
+static inline int precede(const Point *A, const Point *B){
+    return (A->x < B->x) || (A->x == B->x && A->y < B->y);
+}
+
+/**
+ * @brief Tri rapide des points selon (x, y), sans l'appel de fonction de comparaison de qsort
+ * à chaque comparaison. Récursion sur la plus petite partie, insertion pour les petites parties
+ */
+static void triePoints(PointTrie *tri, int n){
+    while (n > 16){
+        PointTrie tmp;
+        int milieu = n / 2;
+
+        // Médiane de trois placée au milieu
+        if (precede(&tri[milieu].p, &tri[0].p)){ tmp = tri[0]; tri[0] = tri[milieu]; tri[milieu] = tmp; }
+        if (precede(&tri[n - 1].p, &tri[0].p)){ tmp = tri[0]; tri[0] = tri[n - 1]; tri[n - 1] = tmp; }
+        if (precede(&tri[n - 1].p, &tri[milieu].p)){ tmp = tri[milieu]; tri[milieu] = tri[n - 1]; tri[n - 1] = tmp; }
+
+        Point pivot = tri[milieu].p;
+        int i = 0;
+        int j = n - 1;
+
+        while (i <= j){
+            while (precede(&tri[i].p, &pivot)){ i++; }
+            while (precede(&pivot, &tri[j].p)){ j--; }
+            if (i <= j){
+                tmp = tri[i]; tri[i] = tri[j]; tri[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+
+        if (j + 1 < n - i){
+            triePoints(tri, j + 1);
+            tri += i;
+            n -= i;
+        }
+        else{
+            triePoints(tri + i, n - i);
+            n = j + 1;
+        }
+    }
+
+    for (int i = 1; i < n; i++){
+        PointTrie courant = tri[i];
+        int j = i - 1;
+        while (j >= 0 && precede(&courant.p, &tri[j].p)){
+            tri[j + 1] = tri[j];
+            j--;
+        }
+        tri[j + 1] = courant;
+    }
+}
+
+/**
+ * @brief Renvoie une copie contiguë de points du nuage, triée selon (x, y)
+ *
+ * @param nuage Le nuage
+ * @param indices Indices des points à copier (NULL: tous les points du nuage)
+ * @param nbPoint Nombre de points à copier
+ */
+static PointTrie *copieTriee(const NuagePoints *nuage, const int *indices, int nbPoint){
+    PointTrie *tri = (PointTrie *) malloc(nbPoint * sizeof(PointTrie));
+    if (!tri){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    for (int i = 0; i < nbPoint; i++){
+        int s = indices ? indices[i] : i;
+        tri[i].p.x = nuage->x[s];
+        tri[i].p.y = nuage->y[s];
+        tri[i].s = s;
+    }
+
+    triePoints(tri, nbPoint);
+
+    return tri;
+}
+
+/**
+ * @brief Balayage de la chaîne monotone d'Andrew sur des points triés selon (x, y). Les doublons
+ * sont supprimés au passage
+ *
+ * @param tri Les points triés (modifié : les doublons sont retirés)
+ * @param nbPoint Nombre de points (au moins 1)
+ * @param chaine Tableau de travail (2 * nbPoint cases)
+ * @param sommets Tableau (nbPoint + 1 cases) où écrire les indices dans le nuage des sommets, dans
+ * l'ordre de l'enveloppe en partant du plus petit point selon (x, y)
+ * @return Le nombre de sommets
+ */
+static int balayage(PointTrie *tri, int nbPoint, int *chaine, int *sommets){
+    // Suppression des doublons
+    int n = 1;
+    for (int i = 1; i < nbPoint; i++){
+        if (precede(&tri[n - 1].p, &tri[i].p)){
+            tri[n++] = tri[i];
+        }
+    }
+
+    int k = 0;
+
+    // Chaîne inférieure, de gauche à droite
+    for (int i = 0; i < n; i++){
+        while (k >= 2 && orientationTriangle(tri[chaine[k - 2]].p, tri[chaine[k - 1]].p, tri[i].p) <= 0){
+            k -= 1;
+        }
+        chaine[k++] = i;
+    }
+
+    // Chaîne supérieure, de droite à gauche
+    for (int i = n - 2, t = k + 1; i >= 0; i--){
+        while (k >= t && orientationTriangle(tri[chaine[k - 2]].p, tri[chaine[k - 1]].p, tri[i].p) <= 0){
+            k -= 1;
+        }
+        chaine[k++] = i;
+    }
+
+    // Le premier point termine aussi la chaîne supérieure
+    if (n > 1){
+        k -= 1;
+    }
+
+    for (int i = 0; i < k; i++){
+        sommets[i] = tri[chaine[i]].s;
+    }
+
+    return k;
+}
+
+/**
+ * @brief Renvoie un tableau de travail de n entiers
+ */
+static int *alloueEntiers(int n){
+    int *tableau = (int *) malloc(n * sizeof(int));
+    if (!tableau){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    return tableau;
+}
+
+int sommetsEnveloppe(const NuagePoints *nuage, const int *indices, int nbPoint, int *sommets){
+    if (nbPoint <= 0){
+        return 0;
+    }
+
+    PointTrie *tri = copieTriee(nuage, indices, nbPoint);
+    int *chaine = alloueEntiers(2 * nbPoint);
+    int k = balayage(tri, nbPoint, chaine, sommets);
+    free(chaine);
+    free(tri);
+
+    return k;
+}
+
+int sommetsTries(const NuagePoints *nuage, const int *tries, int nbPoint, int *sommets){
+    if (nbPoint <= 0){
+        return 0;
+    }
+
+    PointTrie *tri = (PointTrie *) malloc(nbPoint * sizeof(PointTrie));
+    if (!tri){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    for (int i = 0; i < nbPoint; i++){
+        tri[i].p = pointNuage(nuage, tries[i]);
+        tri[i].s = tries[i];
+    }
+
+    int *chaine = alloueEntiers(2 * nbPoint);
+    int k = balayage(tri, nbPoint, chaine, sommets);
+    free(chaine);
+    free(tri);
+
+    return k;
+}
+
+void remplitEnveloppe(const NuagePoints *nuage, const int *sommets, int nbSommet, ConvexHull *enveloppe){
+    reserveAnneau(enveloppe, nbSommet);
+    for (int i = 0; i < nbSommet; i++){
+        int ins = newCell(enveloppe, pointNuage(nuage, sommets[i]), sommets[i]);
+        addBefore(enveloppe, enveloppe->pol, ins);
+    }
+
+    enveloppe->curlen = nbSommet;
+    if (nbSommet > enveloppe->maxlen){
+        enveloppe->maxlen = nbSommet;
+    }
+}
+
+/**
+ * @brief Chaîne monotone d'Andrew sur une partie des points du nuage
+ *
+ * @param indices Indices des points (NULL: tous les points du nuage)
+ * @param nbPoint Nombre de points
+ */
+static void enveloppeIndices(const NuagePoints *nuage, const int *indices, int nbPoint, ConvexHull *enveloppe){
+    enveloppe->curlen = 0;
+
+    if (nbPoint <= 0){
+        return;
+    }
+
+    int *sommets = (int *) malloc((nbPoint + 1) * sizeof(int));
+    if (!sommets){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    int k = sommetsEnveloppe(nuage, indices, nbPoint, sommets);
+    remplitEnveloppe(nuage, sommets, k, enveloppe);
+
+    free(sommets);
+}
+
+void enveloppeStatique(const NuagePoints *nuage, ConvexHull *enveloppe){
+    enveloppeIndices(nuage, NULL, nuage->nbPoint, enveloppe);
+}
+
+void construitMoteur(Moteur *moteur){
+    const NuagePoints *nuage = moteur->nuage;
+    int nbPoint = nuage->nbPoint;
+
+    // L'ancien contenu est rendu d'un coup, et les blocs dimensionnés d'après nbPoint
+    freeListeConvexe(&(moteur->listeConvexe));
+    liberePool(&(moteur->noeuds));
+    reserveMoteur(moteur, nbPoint);
+    moteur->nbConvexe = 0;
+    moteur->nbPrefiltre = 0;
+
+    if (moteur->options & MOTEUR_COUCHES){
+        // Les points intérieurs forment les couches suivantes : pas de préfiltre
+        couchesStatiques(nuage, &(moteur->listeConvexe), &(moteur->nbConvexe));
+    }
+    else if (nbPoint > 0){
+        int grille = -1;
+        insereQueueConvexe(&(moteur->listeConvexe));
+        if (!moteur->listeConvexe){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+
+        moteur->listeConvexe->numero = moteur->nbConvexe;
+        moteur->nbConvexe += 1;
+
+        // Un point hors de la grille fait revenir au calcul général
+        if (moteur->options & MOTEUR_GRILLE){
+            grille = enveloppeGrille(nuage, moteur->listeConvexe, moteur->largeurGrille);
+        }
+
+        if (grille >= 0){
+            moteur->nbPrefiltre = grille;
+        }
+        else if (moteur->options & MOTEUR_CHAN){
+            moteur->nbPrefiltre = enveloppeChan(nuage, moteur->listeConvexe, moteur->options & MOTEUR_PREFILTRE);
+        }
+        else if (moteur->options & MOTEUR_QUICKHULL){
+            moteur->nbPrefiltre = quickHullParallele(nuage, moteur->listeConvexe, moteur->nbThread,
+                                                     moteur->options & MOTEUR_PREFILTRE);
+        }
+        else if (moteur->nbThread != 1){
+            moteur->nbPrefiltre = enveloppeParallele(nuage, moteur->listeConvexe, moteur->nbThread,
+                                                     moteur->options & MOTEUR_PREFILTRE);
+        }
+        else if (moteur->options & MOTEUR_PREFILTRE){
+            int *gardes = (int *) malloc(nbPoint * sizeof(int));
+            if (!gardes){
+                fprintf(stderr,"Plus de memoire ");
+                exit(-1);
+            }
+
+            int nbGarde = prefiltreOctogone(nuage, 0, nbPoint, gardes);
+            moteur->nbPrefiltre = nbPoint - nbGarde;
+            enveloppeIndices(nuage, gardes, nbGarde, moteur->listeConvexe);
+
+            free(gardes);
+        }
+        else{
+            enveloppeStatique(nuage, moteur->listeConvexe);
+        }
+    }
+
+    // Toutes les couches sont nouvelles
+    moteur->version += 1;
+    for (ConvexHull *parcours = moteur->listeConvexe; parcours; parcours = parcours->next){
+        parcours->modification = moteur->version;
+        if (!(moteur->options & MOTEUR_LINEAIRE)){
+            construitIndex(parcours, &(moteur->noeuds));
+        }
+    }
+}
+
+/////////////////////////////////////////
+// Couches convexes par arbre de ponts //
+/////////////////////////////////////////
+
+/*
+ * Épluchage en couches convexes à la manière de Chazelle. Un arbre binaire complet est construit
+ * sur les points distincts triés selon (x, y) ; chaque noeud garde le pont qui relie la chaîne
+ * supérieure (resp. inférieure) de son fils gauche à celle de son fils droit, restreintes aux
+ * points encore vivants. La chaîne d'un noeud n'est jamais stockée : elle se lit en descendant
+ * les ponts. Chaque couche est lue à la racine, ses points sont supprimés, puis seuls les ponts
+ * des noeuds touchés sont réparés, en repartant de leur ancienne position : une suppression ne
+ * fait que découvrir des points entre les voisins du sommet supprimé.
+ */
+
+#define SUPERIEURE 0
+#define INFERIEURE 1
+
+/**
+ * @brief Arbre des ponts sur les points distincts triés
+ *
+ */
+typedef struct{
+    PointTrie *tri; /* tous les points triés, doublons compris */
+    int n; /* nombre de points distincts (feuilles) */
+    int *debut; /* premier exemplaire de chaque point distinct dans tri */
+    int *restant; /* exemplaires non encore placés dans une couche (0: feuille morte) */
+    int *vivants; /* nombre de feuilles vivantes de chaque noeud */
+    int *pontGauche[2]; /* extrémité gauche du pont de chaque noeud, par chaîne */
+    int *pontDroit[2]; /* extrémité droite du pont de chaque noeud, par chaîne */
+    char *touche; /* noeuds dont une feuille est morte depuis la dernière réparation */
+} ArbreCouches;
+
+/**
+ * @brief Renvoie un entier positif si la feuille k est strictement à l'extérieur de la droite
+ * (i, j) pour la chaîne c (au-dessus pour la chaîne supérieure), nul si elle est sur la droite
+ */
+static int cote(const ArbreCouches *arbre, int c, int i, int j, int k){
+    int orientation = orientationTriangle(arbre->tri[arbre->debut[i]].p, arbre->tri[arbre->debut[j]].p,
+                                          arbre->tri[arbre->debut[k]].p);
+
+    return (c == SUPERIEURE) ? orientation : -orientation;
+}
+
+static int premierVivant(const ArbreCouches *arbre, int v, int lo, int hi){
+    while (hi - lo > 1){
+        int mid = (lo + hi) / 2;
+        if (arbre->vivants[2 * v] > 0){
+            v = 2 * v; hi = mid;
+        }
+        else{
+            v = 2 * v + 1; lo = mid;
+        }
+    }
+    return lo;
+}
+
+static int dernierVivant(const ArbreCouches *arbre, int v, int lo, int hi){
+    while (hi - lo > 1){
+        int mid = (lo + hi) / 2;
+        if (arbre->vivants[2 * v + 1] > 0){
+            v = 2 * v + 1; lo = mid;
+        }
+        else{
+            v = 2 * v; hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Renvoie le sommet qui suit p sur la chaîne c du noeud v, -1 si p est le dernier
+ */
+static int suivant(const ArbreCouches *arbre, int c, int v, int lo, int hi, int p){
+    while (hi - lo > 1){
+        int mid = (lo + hi) / 2;
+        if (p < mid){
+            if (arbre->vivants[2 * v + 1] > 0 && p == arbre->pontGauche[c][v]){
+                return arbre->pontDroit[c][v];
+            }
+            v = 2 * v; hi = mid;
+        }
+        else{
+            v = 2 * v + 1; lo = mid;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Renvoie le sommet qui précède p sur la chaîne c du noeud v, -1 si p est le premier
+ */
+static int precedent(const ArbreCouches *arbre, int c, int v, int lo, int hi, int p){
+    while (hi - lo > 1){
+        int mid = (lo + hi) / 2;
+        if (p >= mid){
+            if (arbre->vivants[2 * v] > 0 && p == arbre->pontDroit[c][v]){
+                return arbre->pontGauche[c][v];
+            }
+            v = 2 * v + 1; lo = mid;
+        }
+        else{
+            v = 2 * v; hi = mid;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Renvoie le dernier sommet de la chaîne c du noeud v d'indice inférieur ou égal à i,
+ * -1 s'il n'y en a pas
+ */
+static int sommetAvant(const ArbreCouches *arbre, int c, int v, int lo, int hi, int i){
+    while (hi - lo > 1){
+        int mid = (lo + hi) / 2;
+        if (arbre->vivants[2 * v] == 0){
+            v = 2 * v + 1; lo = mid;
+        }
+        else if (arbre->vivants[2 * v + 1] == 0){
+            v = 2 * v; hi = mid;
+        }
+        else if (i >= arbre->pontDroit[c][v]){
+            v = 2 * v + 1; lo = mid;
+        }
+        else if (i >= arbre->pontGauche[c][v]){
+            return arbre->pontGauche[c][v];
+        }
+        else{
+            v = 2 * v; hi = mid;
+        }
+    }
+    return (arbre->vivants[v] > 0 && lo <= i) ? lo : -1;
+}
+
+/**
+ * @brief Calcule le pont de la chaîne c du noeud v, dont les deux fils ont des points vivants.
+ * Les extrémités glissent le long des chaînes des fils jusqu'à ce que plus aucun voisin ne
+ * soit au-dessus de la droite (les points alignés sont écartés vers l'extérieur)
+ *
+ * @param reparation 1 pour repartir de l'ancien pont, 0 pour partir du milieu
+ */
+static void calculePont(ArbreCouches *arbre, int c, int v, int lo, int hi, int reparation){
+    int mid = (lo + hi) / 2;
+    int g = 2 * v;
+    int d = 2 * v + 1;
+    int p, q, r;
+
+    if (reparation){
+        p = arbre->pontGauche[c][v];
+        if (!arbre->restant[p]){
+            p = sommetAvant(arbre, c, g, lo, mid, p);
+        }
+        if (p < 0){
+            p = premierVivant(arbre, g, lo, mid);
+        }
+
+        q = arbre->pontDroit[c][v];
+        if (!arbre->restant[q]){
+            q = sommetAvant(arbre, c, d, mid, hi, q);
+        }
+        if (q < 0){
+            q = premierVivant(arbre, d, mid, hi);
+        }
+    }
+    else{
+        p = dernierVivant(arbre, g, lo, mid);
+        q = premierVivant(arbre, d, mid, hi);
+    }
+
+    int bouge = 1;
+    while (bouge){
+        bouge = 0;
+
+        while ((r = precedent(arbre, c, g, lo, mid, p)) >= 0 && cote(arbre, c, p, q, r) >= 0){
+            p = r; bouge = 1;
+        }
+        while ((r = suivant(arbre, c, g, lo, mid, p)) >= 0 && cote(arbre, c, p, q, r) > 0){
+            p = r; bouge = 1;
+        }
+        while ((r = suivant(arbre, c, d, mid, hi, q)) >= 0 && cote(arbre, c, p, q, r) >= 0){
+            q = r; bouge = 1;
+        }
+        while ((r = precedent(arbre, c, d, mid, hi, q)) >= 0 && cote(arbre, c, p, q, r) > 0){
+            q = r; bouge = 1;
+        }
+    }
+
+    arbre->pontGauche[c][v] = p;
+    arbre->pontDroit[c][v] = q;
+}
+
+static void construitArbre(ArbreCouches *arbre, int v, int lo, int hi){
+    arbre->vivants[v] = hi - lo;
+    arbre->touche[v] = 0;
+
+    if (hi - lo <= 1){
+        return;
+    }
+
+    int mid = (lo + hi) / 2;
+    construitArbre(arbre, 2 * v, lo, mid);
+    construitArbre(arbre, 2 * v + 1, mid, hi);
+
+    calculePont(arbre, SUPERIEURE, v, lo, hi, 0);
+    calculePont(arbre, INFERIEURE, v, lo, hi, 0);
+}
+
+static void repareArbre(ArbreCouches *arbre, int v, int lo, int hi){
+    if (!arbre->touche[v]){
+        return;
+    }
+    arbre->touche[v] = 0;
+
+    if (hi - lo <= 1){
+        return;
+    }
+
+    int mid = (lo + hi) / 2;
+    repareArbre(arbre, 2 * v, lo, mid);
+    repareArbre(arbre, 2 * v + 1, mid, hi);
+
+    if (arbre->vivants[2 * v] > 0 && arbre->vivants[2 * v + 1] > 0){
+        calculePont(arbre, SUPERIEURE, v, lo, hi, 1);
+        calculePont(arbre, INFERIEURE, v, lo, hi, 1);
+    }
+}
+
+/**
+ * @brief Supprime une feuille de l'arbre et marque ses ancêtres à réparer
+ */
+static void supprimeFeuille(ArbreCouches *arbre, int i){
+    int v = 1;
+    int lo = 0;
+    int hi = arbre->n;
+
+    while (1){
+        arbre->vivants[v] -= 1;
+        arbre->touche[v] = 1;
+
+        if (hi - lo <= 1){
+            return;
+        }
+
+        int mid = (lo + hi) / 2;
+        if (i < mid){
+            v = 2 * v; hi = mid;
+        }
+        else{
+            v = 2 * v + 1; lo = mid;
+        }
+    }
+}
+
+void couchesStatiques(const NuagePoints *nuage, ListeConvexe *listeConvexe, int *nbConvexe){
+    int nbPoint = nuage->nbPoint;
+
+    if (nbPoint <= 0){
+        return;
+    }
+
+    ArbreCouches arbre;
+    arbre.tri = copieTriee(nuage, NULL, nbPoint);
+
+    // Regroupement des doublons : une feuille par point distinct
+    arbre.debut = (int *) malloc((nbPoint + 1) * sizeof(int));
+    arbre.restant = (int *) malloc(nbPoint * sizeof(int));
+    arbre.n = 0;
+    for (int i = 0; i < nbPoint; i++){
+        if (i == 0 || precede(&arbre.tri[i - 1].p, &arbre.tri[i].p)){
+            arbre.debut[arbre.n++] = i;
+        }
+    }
+    arbre.debut[arbre.n] = nbPoint;
+
+    int n = arbre.n;
+    arbre.vivants = (int *) malloc(4 * n * sizeof(int));
+    arbre.touche = (char *) malloc(4 * n * sizeof(char));
+    int *couche = (int *) malloc(n * sizeof(int));
+    for (int c = SUPERIEURE; c <= INFERIEURE; c++){
+        arbre.pontGauche[c] = (int *) malloc(4 * n * sizeof(int));
+        arbre.pontDroit[c] = (int *) malloc(4 * n * sizeof(int));
+        if (!arbre.pontGauche[c] || !arbre.pontDroit[c]){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+    }
+    if (!arbre.debut || !arbre.restant || !arbre.vivants || !arbre.touche || !couche){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    for (int i = 0; i < n; i++){
+        arbre.restant[i] = arbre.debut[i + 1] - arbre.debut[i];
+    }
+
+    construitArbre(&arbre, 1, 0, n);
+
+    ConvexHull *queue = *listeConvexe;
+    if (queue){
+        for (; queue->next; queue = queue->next);
+    }
+
+    while (arbre.vivants[1] > 0){
+        int k = 0;
+        int gauche = premierVivant(&arbre, 1, 0, n);
+        int droite = dernierVivant(&arbre, 1, 0, n);
+
+        // Chaîne inférieure de gauche à droite, puis chaîne supérieure de droite à gauche :
+        // même sens de parcours que l'insertion en ligne
+        for (int i = gauche; i >= 0; i = suivant(&arbre, INFERIEURE, 1, 0, n, i)){
+            couche[k++] = i;
+        }
+        for (int i = precedent(&arbre, SUPERIEURE, 1, 0, n, droite); i >= 0 && i != gauche;
+             i = precedent(&arbre, SUPERIEURE, 1, 0, n, i)){
+            couche[k++] = i;
+        }
+
+        ConvexHull *enveloppe = alloueCelluleConvexe();
+        if (!enveloppe){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        enveloppe->numero = *nbConvexe;
+        *nbConvexe += 1;
+
+        reserveAnneau(enveloppe, k);
+        for (int j = 0; j < k; j++){
+            int i = couche[j];
+            int exemplaire = arbre.debut[i + 1] - arbre.restant[i];
+
+            int ins = newCell(enveloppe, arbre.tri[exemplaire].p, arbre.tri[exemplaire].s);
+            addBefore(enveloppe, enveloppe->pol, ins);
+
+            // Le point disparaît de l'arbre avec son dernier exemplaire
+            arbre.restant[i] -= 1;
+            if (!arbre.restant[i]){
+                supprimeFeuille(&arbre, i);
+            }
+        }
+        enveloppe->curlen = enveloppe->maxlen = k;
+
+        if (queue){
+            queue->next = enveloppe;
+        }
+        else{
+            *listeConvexe = enveloppe;
+        }
+        queue = enveloppe;
+
+        repareArbre(&arbre, 1, 0, n);
+    }
+
+    for (int c = SUPERIEURE; c <= INFERIEURE; c++){
+        free(arbre.pontGauche[c]);
+        free(arbre.pontDroit[c]);
+    }
+    free(couche);
+    free(arbre.touche);
+    free(arbre.vivants);
+    free(arbre.restant);
+    free(arbre.debut);
+    free(arbre.tri);
+}
+
+///////////////////////
+// Enveloppe de Chan //
+///////////////////////
+
+/*
+ * Algorithme de Chan, en O(n log h) : pour m = 4, 16, 256... les points sont découpés en groupes
+ * de m, dont les enveloppes sont calculées par la chaîne monotone ; puis au plus m pas de marche
+ * de Jarvis sont tentés, la tangente à chaque groupe étant cherchée par dichotomie. Si
+ * l'enveloppe ne s'est pas refermée, m est élevé au carré.
+ */
+
+/**
+ * @brief Renvoie 1 si R, aligné avec P et Q et du même côté de P, est plus loin de P que Q
+ * (comparaison exacte des coordonnées)
+ */
+static inline int plusLoin(Point P, Point Q, Point R){
+    if (Q.x != P.x){
+        return (Q.x > P.x) ? (R.x > Q.x) : (R.x < Q.x);
+    }
+    if (Q.y != P.y){
+        return (Q.y > P.y) ? (R.y > Q.y) : (R.y < Q.y);
+    }
+    return R.x != P.x || R.y != P.y;
+}
+
+/**
+ * @brief Renvoie 1 si R est un meilleur successeur de P que Q dans la marche de Jarvis :
+ * strictement à droite de (P, Q), ou aligné et plus loin
+ */
+static inline int meilleurSuccesseur(Point P, Point Q, Point R){
+    int orientation = orientationTriangle(P, Q, R);
+
+    if (orientation != 0){
+        return orientation < 0;
+    }
+    return plusLoin(P, Q, R);
+}
+
+static inline int memePoint(Point A, Point B){
+    return A.x == B.x && A.y == B.y;
+}
+
+/**
+ * @brief Tangente par un parcours de tout le polygone
+ */
+static int tangenteLineaire(const NuagePoints *nuage, Point P, const int *V, int n){
+    int t = -1;
+
+    for (int i = 0; i < n; i++){
+        Point Vi = pointNuage(nuage, V[i]);
+        if (!memePoint(Vi, P) && (t < 0 || meilleurSuccesseur(P, pointNuage(nuage, V[t]), Vi))){
+            t = i;
+        }
+    }
+
+    return t;
+}
+
+/**
+ * @brief Cherche le sommet q d'un polygone convexe (orienté comme l'enveloppe) tel que tout le
+ * polygone soit à gauche de (P, q) ou sur la droite, le plus loin de P parmi les sommets alignés.
+ * Dichotomie de Sunday sur le signe des arêtes vues de P ; le résultat est vérifié sur ses deux
+ * voisins (ce qui suffit pour un polygone convexe) et les cas dégénérés (P sommet du polygone,
+ * ou aligné avec une arête) se rabattent sur un parcours
+ *
+ * @param V Indices des sommets
+ * @param n Nombre de sommets
+ * @return Le rang du sommet dans V, -1 si tous les sommets sont confondus avec P
+ */
+static int tangente(const NuagePoints *nuage, Point P, const int *V, int n){
+    if (n <= CHAN_LINEAIRE){
+        return tangenteLineaire(nuage, P, V, n);
+    }
+
+    // Les rangs utilisés restent entre -1 et n + 1
+    #define SOMMET(i) pointNuage(nuage, V[((i) < 0) ? (i) + n : (((i) >= n) ? (i) - n : (i))])
+    #define DESSUS(i, j) (orientationTriangle(P, SOMMET(i), SOMMET(j)) > 0)
+    #define DESSOUS(i, j) (orientationTriangle(P, SOMMET(i), SOMMET(j)) < 0)
+
+    int t = -1;
+
+    if (DESSOUS(1, 0) && !DESSUS(n - 1, 0)){
+        t = 0;
+    }
+    else{
+        int a = 0;
+        int b = n;
+        while (b - a > 1){
+            int c = (a + b) / 2;
+            int descendC = DESSOUS(c + 1, c);
+
+            if (descendC && !DESSUS(c - 1, c)){
+                t = c;
+                break;
+            }
+
+            if (DESSUS(a + 1, a)){
+                if (descendC || DESSUS(a, c)){
+                    b = c;
+                }
+                else{
+                    a = c;
+                }
+            }
+            else{
+                if (!descendC || !DESSOUS(a, c)){
+                    a = c;
+                }
+                else{
+                    b = c;
+                }
+            }
+        }
+    }
+
+    if (t < 0 || memePoint(SOMMET(t), P)
+        || orientationTriangle(P, SOMMET(t), SOMMET(t - 1)) < 0
+        || orientationTriangle(P, SOMMET(t), SOMMET(t + 1)) < 0){
+        return tangenteLineaire(nuage, P, V, n);
+    }
+
+    // Un voisin aligné avec P et plus loin est préféré
+    if (orientationTriangle(P, SOMMET(t), SOMMET(t + 1)) == 0 && plusLoin(P, SOMMET(t), SOMMET(t + 1))){
+        t = (t + 1) % n;
+    }
+    else if (orientationTriangle(P, SOMMET(t), SOMMET(t - 1)) == 0 && plusLoin(P, SOMMET(t), SOMMET(t - 1))){
+        t = (t + n - 1) % n;
+    }
+
+    #undef SOMMET
+    #undef DESSUS
+    #undef DESSOUS
+
+    return t;
+}
+
+/**
+ * @brief Un tour de l'algorithme de Chan avec des groupes de m points
+ *
+ * @param indices Indices des points
+ * @param nbPoint Nombre de points
+ * @param m Taille des groupes
+ * @param resultat Tableau (m cases) où écrire les sommets de l'enveloppe
+ * @return Le nombre de sommets, -1 si l'enveloppe a plus de m sommets
+ */
+static int tourChan(const NuagePoints *nuage, const int *indices, int nbPoint, int m, int *resultat){
+    int nbGroupe = (nbPoint + m - 1) / m;
+    int *sommets = alloueEntiers(nbPoint + nbGroupe);
+    int *debut = alloueEntiers(nbGroupe + 1);
+    int *chaine = alloueEntiers(2 * m);
+    PointTrie *tri = (PointTrie *) malloc(m * sizeof(PointTrie));
+    if (!tri){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    // Enveloppes des groupes, rangées bout à bout ; chacune part de son plus petit point
+    int premier = 0;
+    debut[0] = 0;
+    for (int g = 0; g < nbGroupe; g++){
+        int taille = (nbPoint - g * m < m) ? nbPoint - g * m : m;
+        for (int i = 0; i < taille; i++){
+            tri[i].s = indices[g * m + i];
+            tri[i].p = pointNuage(nuage, tri[i].s);
+        }
+        triePoints(tri, taille);
+
+        int k = balayage(tri, taille, chaine, sommets + debut[g]);
+        debut[g + 1] = debut[g] + k;
+
+        Point P = pointNuage(nuage, sommets[debut[g]]);
+        Point Q = pointNuage(nuage, sommets[debut[premier]]);
+        if (P.x < Q.x || (P.x == Q.x && P.y < Q.y)){
+            premier = g;
+        }
+    }
+
+    // Marche de Jarvis depuis le plus petit point, avec un sommet courant connu dans son groupe
+    int groupe = premier;
+    int rang = 0;
+    Point depart = pointNuage(nuage, sommets[debut[premier]]);
+    int k = -1;
+
+    for (int pas = 0; pas < m; pas++){
+        int courant = sommets[debut[groupe] + rang];
+        Point P = pointNuage(nuage, courant);
+        resultat[pas] = courant;
+
+        int meilleur = -1;
+        int meilleurGroupe = -1;
+        int meilleurRang = -1;
+
+        for (int g = 0; g < nbGroupe; g++){
+            const int *V = sommets + debut[g];
+            int n = debut[g + 1] - debut[g];
+            int t;
+
+            if (g == groupe){
+                if (n == 1){
+                    continue;
+                }
+                t = (rang + 1) % n;
+            }
+            else{
+                t = tangente(nuage, P, V, n);
+                if (t < 0){
+                    continue;
+                }
+            }
+
+            if (meilleur < 0 || meilleurSuccesseur(P, pointNuage(nuage, meilleur), pointNuage(nuage, V[t]))){
+                meilleur = V[t];
+                meilleurGroupe = g;
+                meilleurRang = t;
+            }
+        }
+
+        if (meilleur < 0 || memePoint(pointNuage(nuage, meilleur), depart)){
+            k = pas + 1;
+            break;
+        }
+
+        groupe = meilleurGroupe;
+        rang = meilleurRang;
+    }
+
+    free(sommets);
+    free(debut);
+    free(chaine);
+    free(tri);
+
+    return k;
+}
+
+int enveloppeChan(const NuagePoints *nuage, ConvexHull *enveloppe, int prefiltre){
+    int nbPoint = nuage->nbPoint;
+    enveloppe->curlen = 0;
+
+    if (nbPoint <= 0){
+        return 0;
+    }
+
+    int *indices = (int *) malloc(nbPoint * sizeof(int));
+    if (!indices){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+
+    int n = nbPoint;
+    if (prefiltre){
+        n = prefiltreOctogone(nuage, 0, nbPoint, indices);
+    }
+    else{
+        for (int i = 0; i < nbPoint; i++){
+            indices[i] = i;
+        }
+    }
+
+    int *resultat = NULL;
+    int k = -1;
+    for (long m = 4; k < 0; m = m * m){
+        if (m > n){
+            m = n;
+        }
+
+        resultat = (int *) realloc(resultat, m * sizeof(int));
+        if (!resultat){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+
+        k = tourChan(nuage, indices, n, (int) m, resultat);
+    }
+
+    remplitEnveloppe(nuage, resultat, k, enveloppe);
+
+    free(resultat);
+    free(indices);
+
+    return nbPoint - n;
+}
+
+//////////////////////////////////////
+// Enveloppe sur une grille entière //
+//////////////////////////////////////
+
+int enveloppeGrille(const NuagePoints *nuage, ConvexHull *enveloppe, int largeur){
+    int nbPoint = nuage->nbPoint;
+    enveloppe->curlen = 0;
+
+    if (nbPoint <= 0){
+        return 0;
+    }
+    if (largeur <= 0){
+        return -1;
+    }
+
+    // Pour chaque colonne, le point le plus bas et le plus haut (-1: colonne vide)
+    int *bas = alloueEntiers(largeur);
+    int *haut = alloueEntiers(largeur);
+    for (int c = 0; c < largeur; c++){
+        bas[c] = -1;
+        haut[c] = -1;
+    }
+
+    for (int i = 0; i < nbPoint; i++){
+        double x = nuage->x[i];
+        double y = nuage->y[i];
+
+        // Le test de la colonne écarte aussi les abscisses non entières et NaN
+        int c = (x >= 0 && x < largeur) ? (int) x : -1;
+        if (c < 0 || c != x){
+            free(bas);
+            free(haut);
+            return -1;
+        }
+
+        if (bas[c] < 0){
+            bas[c] = i;
+            haut[c] = i;
+        }
+        else if (y < nuage->y[bas[c]]){
+            bas[c] = i;
+        }
+        else if (y > nuage->y[haut[c]]){
+            haut[c] = i;
+        }
+    }
+
+    // Les candidats, colonne par colonne, sont déjà triés selon (x, y)
+    int *candidats = alloueEntiers(2 * largeur);
+    int nbCandidat = 0;
+    for (int c = 0; c < largeur; c++){
+        if (bas[c] >= 0){
+            candidats[nbCandidat++] = bas[c];
+            if (haut[c] != bas[c]){
+                candidats[nbCandidat++] = haut[c];
+            }
+        }
+    }
+
+    int *sommets = alloueEntiers(nbCandidat + 1);
+    int k = sommetsTries(nuage, candidats, nbCandidat, sommets);
+    remplitEnveloppe(nuage, sommets, k, enveloppe);
+
+    free(sommets);
+    free(candidats);
+    free(bas);
+    free(haut);
+
+    return nbPoint - nbCandidat;
+}
@@ -0,0 +1,108 @@
+#ifndef STATIQUE_H
+#define STATIQUE_H
+
+#include "enveloppe.h"
+
+#define CHAN_LINEAIRE 8 /* en dessous de cette taille, la tangente à un groupe est cherchée par un parcours */
+
+/*
+ * Constructions statiques : tous les points sont connus avant le calcul (mode "Terminal"),
+ * on évite donc le coût d'une insertion en ligne par point.
+ */
+
+/**
+ * @brief Calcule l'enveloppe convexe d'un ensemble de points par la chaîne monotone d'Andrew,
+ * en O(n log n). Le polygone obtenu est orienté comme celui de l'insertion en ligne et ses
+ * vertex renvoient aux indices des points du nuage
+ *
+ * @param nuage Le nuage des points
+ * @param enveloppe L'adresse d'une enveloppe vide (pol == -1)
+ */
+void enveloppeStatique(const NuagePoints *nuage, ConvexHull *enveloppe);
+
+/**
+ * @brief Calcule les sommets de l'enveloppe d'une partie des points du nuage par la chaîne
+ * monotone d'Andrew
+ *
+ * @param nuage Le nuage des points
+ * @param indices Indices des points (NULL: les nbPoint premiers points du nuage)
+ * @param nbPoint Nombre de points
+ * @param sommets Tableau (nbPoint + 1 cases) où écrire les indices des sommets, dans l'ordre de
+ * l'enveloppe en partant du plus petit point selon (x, y)
+ * @return Le nombre de sommets
+ */
+int sommetsEnveloppe(const NuagePoints *nuage, const int *indices, int nbPoint, int *sommets);
+
+/**
+ * @brief Comme sommetsEnveloppe, pour des points déjà triés selon (x, y) : le calcul est linéaire
+ *
+ * @param nuage Le nuage des points
+ * @param tries Indices des points, triés selon (x, y) (les doublons sont acceptés)
+ * @param nbPoint Nombre de points
+ * @param sommets Tableau (nbPoint + 1 cases) où écrire les indices des sommets
+ * @return Le nombre de sommets
+ */
+int sommetsTries(const NuagePoints *nuage, const int *tries, int nbPoint, int *sommets);
+
+/**
+ * @brief Range des sommets, donnés dans l'ordre de l'enveloppe, dans l'anneau d'une enveloppe vide
+ *
+ * @param nuage Le nuage des points
+ * @param sommets Indices des sommets dans le nuage
+ * @param nbSommet Nombre de sommets
+ * @param enveloppe L'adresse d'une enveloppe vide (pol == -1)
+ */
+void remplitEnveloppe(const NuagePoints *nuage, const int *sommets, int nbSommet, ConvexHull *enveloppe);
+
+/**
+ * @brief Calcule l'enveloppe convexe de tous les points du nuage par l'algorithme de Chan, en
+ * O(n log h) pour h sommets. Le polygone obtenu est le même que celui de enveloppeStatique
+ *
+ * @param nuage Le nuage des points
+ * @param enveloppe L'adresse d'une enveloppe vide (pol == -1)
+ * @param prefiltre 1 pour appliquer d'abord le préfiltre d'Akl-Toussaint
+ * @return Le nombre de points écartés par le préfiltre
+ */
+int enveloppeChan(const NuagePoints *nuage, ConvexHull *enveloppe, int prefiltre);
+
+/**
+ * @brief Calcule l'enveloppe convexe de points à abscisses entières comprises entre 0 et
+ * largeur - 1 (les points de la fenêtre), en O(n + largeur) : un seul passage garde le point le
+ * plus bas et le plus haut de chaque colonne, puis la chaîne monotone parcourt ces au plus
+ * 2 * largeur candidats, déjà triés. Le polygone obtenu est le même que celui de enveloppeStatique
+ *
+ * @param nuage Le nuage des points
+ * @param enveloppe L'adresse d'une enveloppe vide (pol == -1)
+ * @param largeur Nombre de colonnes de la grille
+ * @return Le nombre de points écartés (ni le plus bas ni le plus haut de leur colonne), -1 si un
+ * point n'est pas sur la grille (l'enveloppe reste alors vide)
+ */
+int enveloppeGrille(const NuagePoints *nuage, ConvexHull *enveloppe, int largeur);
+
+/**
+ * @brief Calcule les couches convexes (épluchage) d'un ensemble de points à l'aide d'un arbre
+ * de ponts à la Chazelle, sans les réinsertions en cascade de traitementRecursif. Les couches
+ * sont les mêmes que celles de l'insertion en ligne en mode MOTEUR_COUCHES : chacune est
+ * formée des sommets stricts de l'enveloppe des points restants
+ *
+ * @param nuage Le nuage des points
+ * @param listeConvexe Adresse de la liste des enveloppes, où ajouter les couches en queue
+ * @param nbConvexe Adresse du compteur d'enveloppes, pour numéroter les couches
+ */
+void couchesStatiques(const NuagePoints *nuage, ListeConvexe *listeConvexe, int *nbConvexe);
+
+/**
+ * @brief Remplace le contenu du moteur par le calcul statique de tous les points de son nuage.
+ * Le moteur peut ensuite recevoir d'autres points avec insereMoteur. Avec MOTEUR_PREFILTRE (et
+ * une seule enveloppe), les points intérieurs à l'octogone d'Akl-Toussaint sont écartés avant
+ * le tri ; leur nombre est rangé dans moteur->nbPrefiltre. Avec MOTEUR_GRILLE, l'enveloppe est
+ * calculée par enveloppeGrille sur moteur->largeurGrille colonnes, sauf si un point n'est pas sur
+ * la grille ; les points écartés par les colonnes sont comptés dans moteur->nbPrefiltre. Avec
+ * MOTEUR_CHAN, l'enveloppe est calculée par enveloppeChan ; avec MOTEUR_QUICKHULL, par
+ * quickHullParallele ; sinon, si moteur->nbThread vaut 0 ou plus de 1, par enveloppeParallele
+ *
+ * @param moteur Le moteur
+ */
+void construitMoteur(Moteur *moteur);
+
+#endif
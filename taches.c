@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "taches.h"
+
+#define FILE_MIN 64 /* capacité initiale d'une file de tâches */
+
+/**
+ * @brief Une tâche en attente
+ *
+ */
+typedef struct{
+    void (*fonction)(void *); /* la fonction à exécuter */
+    void *arg; /* son argument */
+    GroupeTaches *groupe; /* le groupe prévenu à la fin */
+} Tache;
+
+/**
+ * @brief File à deux bouts d'un ouvrier : tableau circulaire qui grandit au besoin
+ *
+ */
+typedef struct{
+    pthread_mutex_t verrou;
+    Tache *taches;
+    int capacite; /* taille du tableau (puissance de 2) */
+    int haut; /* indice (croissant) de la plus ancienne tâche, volée en premier */
+    int bas; /* indice (croissant) qui suit la plus récente tâche */
+} FileTaches;
+
+struct s_pool_taches{
+    int nbOuvrier; /* ouvriers, thread appelant compris */
+    FileTaches *files; /* une file par ouvrier (la 0 est celle du thread appelant) */
+    pthread_t *threads; /* les threads des ouvriers 1 à nbOuvrier - 1 */
+    atomic_int nbEnFile; /* tâches en file, pour endormir les ouvriers inoccupés */
+    atomic_int arret; /* 1 pour arrêter les ouvriers */
+    pthread_mutex_t verrou; /* protège le sommeil des ouvriers */
+    pthread_cond_t reveil; /* signalé à chaque nouvelle tâche */
+};
+
+/**
+ * @brief Argument d'un thread ouvrier
+ *
+ */
+typedef struct{
+    PoolTaches *pool;
+    int numero;
+} Ouvrier;
+
+// Ouvrier exécuté par le thread courant (la file 0 pour un thread étranger au groupe)
+static __thread PoolTaches *poolCourant = NULL;
+static __thread int ouvrierCourant = 0;
+
+/////////////////////
+// Fonctions files //
+/////////////////////
+
+static void initFile(FileTaches *file){
+    pthread_mutex_init(&(file->verrou), NULL);
+    file->taches = (Tache *) malloc(FILE_MIN * sizeof(Tache));
+    if (!file->taches){
+        fprintf(stderr,"Plus de memoire ");
+        exit(-1);
+    }
+    file->capacite = FILE_MIN;
+    file->haut = 0;
+    file->bas = 0;
+}
+
+static void empile(FileTaches *file, Tache tache){
+    pthread_mutex_lock(&(file->verrou));
+
+    if (file->bas - file->haut == file->capacite){
+        Tache *taches = (Tache *) malloc(2 * file->capacite * sizeof(Tache));
+        if (!taches){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        for (int i = file->haut; i < file->bas; i++){
+            taches[i & (2 * file->capacite - 1)] = file->taches[i & (file->capacite - 1)];
+        }
+        free(file->taches);
+        file->taches = taches;
+        file->capacite *= 2;
+    }
+
+    file->taches[file->bas & (file->capacite - 1)] = tache;
+    file->bas += 1;
+
+    pthread_mutex_unlock(&(file->verrou));
+}
+
+/**
+ * @brief Retire une tâche de la file : la plus récente pour son ouvrier, la plus ancienne pour un
+ * voleur (les grosses tâches, lancées en premier, sont ainsi volées)
+ *
+ * @return 1 si une tâche a été retirée, 0 si la file est vide
+ */
+static int retire(FileTaches *file, int vol, Tache *tache){
+    int trouve = 0;
+
+    pthread_mutex_lock(&(file->verrou));
+    if (file->bas > file->haut){
+        if (vol){
+            *tache = file->taches[file->haut & (file->capacite - 1)];
+            file->haut += 1;
+        }
+        else{
+            file->bas -= 1;
+            *tache = file->taches[file->bas & (file->capacite - 1)];
+        }
+        trouve = 1;
+    }
+    pthread_mutex_unlock(&(file->verrou));
+
+    return trouve;
+}
+
+////////////////////////
+// Fonctions ouvriers //
+////////////////////////
+
+/**
+ * @brief Cherche une tâche dans la file de l'ouvrier, puis dans celles des autres
+ *
+ * @return 1 si une tâche a été trouvée
+ */
+static int prendTache(PoolTaches *pool, int numero, Tache *tache){
+    if (retire(pool->files + numero, 0, tache)){
+        atomic_fetch_sub(&(pool->nbEnFile), 1);
+        return 1;
+    }
+
+    for (int i = 1; i < pool->nbOuvrier; i++){
+        if (retire(pool->files + (numero + i) % pool->nbOuvrier, 1, tache)){
+            atomic_fetch_sub(&(pool->nbEnFile), 1);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static void executeTache(Tache tache){
+    tache.fonction(tache.arg);
+    atomic_fetch_sub(&(tache.groupe->restant), 1);
+}
+
+static void *boucleOuvrier(void *arg){
+    Ouvrier *ouvrier = (Ouvrier *) arg;
+    PoolTaches *pool = ouvrier->pool;
+    Tache tache;
+
+    poolCourant = pool;
+    ouvrierCourant = ouvrier->numero;
+    free(ouvrier);
+
+    while (!atomic_load(&(pool->arret))){
+        if (prendTache(pool, ouvrierCourant, &tache)){
+            executeTache(tache);
+            continue;
+        }
+
+        pthread_mutex_lock(&(pool->verrou));
+        while (atomic_load(&(pool->nbEnFile)) == 0 && !atomic_load(&(pool->arret))){
+            pthread_cond_wait(&(pool->reveil), &(pool->verrou));
+        }
+        pthread_mutex_unlock(&(pool->verrou));
+    }
+
+    return NULL;
+}
+
+PoolTaches *creePoolTaches(int nbOuvrier){
+    PoolTaches *pool = (PoolTaches *) malloc(sizeof(PoolTaches));
+    if (!pool){
+        return NULL;
+    }
+
+    if (nbOuvrier < 1){
+        nbOuvrier = 1;
+    }
+
+    pool->nbOuvrier = nbOuvrier;
+    pool->files = (FileTaches *) malloc(nbOuvrier * sizeof(FileTaches));
+    pool->threads = (pthread_t *) malloc(nbOuvrier * sizeof(pthread_t));
+    if (!pool->files || !pool->threads){
+        free(pool->files);
+        free(pool->threads);
+        free(pool);
+        return NULL;
+    }
+
+    for (int i = 0; i < nbOuvrier; i++){
+        initFile(pool->files + i);
+    }
+    atomic_init(&(pool->nbEnFile), 0);
+    atomic_init(&(pool->arret), 0);
+    pthread_mutex_init(&(pool->verrou), NULL);
+    pthread_cond_init(&(pool->reveil), NULL);
+
+    poolCourant = pool;
+    ouvrierCourant = 0;
+
+    for (int i = 1; i < nbOuvrier; i++){
+        Ouvrier *ouvrier = (Ouvrier *) malloc(sizeof(Ouvrier));
+        if (!ouvrier){
+            fprintf(stderr,"Plus de memoire ");
+            exit(-1);
+        }
+        ouvrier->pool = pool;
+        ouvrier->numero = i;
+
+        if (pthread_create(pool->threads + i, NULL, boucleOuvrier, ouvrier)){
+            fprintf(stderr,"Creation de thread impossible ");
+            exit(-1);
+        }
+    }
+
+    return pool;
+}
+
+void initGroupe(GroupeTaches *groupe){
+    atomic_init(&(groupe->restant), 0);
+}
+
+void lanceTache(PoolTaches *pool, GroupeTaches *groupe, void (*fonction)(void *), void *arg){
+    Tache tache;
+    tache.fonction = fonction;
+    tache.arg = arg;
+    tache.groupe = groupe;
+
+    atomic_fetch_add(&(groupe->restant), 1);
+    atomic_fetch_add(&(pool->nbEnFile), 1);
+    empile(pool->files + ((poolCourant == pool) ? ouvrierCourant : 0), tache);
+
+    // Le signal, donné sous le verrou, ne peut pas tomber entre le test et le sommeil d'un ouvrier
+    if (pool->nbOuvrier > 1){
+        pthread_mutex_lock(&(pool->verrou));
+        pthread_cond_signal(&(pool->reveil));
+        pthread_mutex_unlock(&(pool->verrou));
+    }
+}
+
+void attendsGroupe(PoolTaches *pool, GroupeTaches *groupe){
+    int numero = (poolCourant == pool) ? ouvrierCourant : 0;
+    Tache tache;
+
+    while (atomic_load(&(groupe->restant)) > 0){
+        if (prendTache(pool, numero, &tache)){
+            executeTache(tache);
+        }
+        else{
+            sched_yield();
+        }
+    }
+}
+
+int nbOuvriers(const PoolTaches *pool){
+    return pool->nbOuvrier;
+}
+
+void detruitPoolTaches(PoolTaches *pool){
+    pthread_mutex_lock(&(pool->verrou));
+    atomic_store(&(pool->arret), 1);
+    pthread_cond_broadcast(&(pool->reveil));
+    pthread_mutex_unlock(&(pool->verrou));
+
+    for (int i = 1; i < pool->nbOuvrier; i++){
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    for (int i = 0; i < pool->nbOuvrier; i++){
+        pthread_mutex_destroy(&(pool->files[i].verrou));
+        free(pool->files[i].taches);
+    }
+    pthread_mutex_destroy(&(pool->verrou));
+    pthread_cond_destroy(&(pool->reveil));
+
+    if (poolCourant == pool){
+        poolCourant = NULL;
+    }
+
+    free(pool->files);
+    free(pool->threads);
+    free(pool);
+}
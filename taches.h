@@ -0,0 +1,65 @@
+#ifndef TACHES_H
+#define TACHES_H
+
+#include <stdatomic.h>
+
+/*
+ * Groupe de threads à vol de tâches : chaque ouvrier a sa file, où il empile et dépile ses
+ * propres tâches par le bas ; un ouvrier sans travail vole une tâche par le haut de la file
+ * d'un autre. Le thread qui attend un groupe de tâches travaille en attendant.
+ */
+
+/**
+ * @brief Ensemble de tâches dont on attend la fin
+ *
+ */
+typedef struct{
+    atomic_int restant; /* tâches lancées et pas encore terminées */
+} GroupeTaches;
+
+typedef struct s_pool_taches PoolTaches;
+
+/**
+ * @brief Crée un groupe de threads. Le thread appelant compte pour un ouvrier : il exécute des
+ * tâches pendant attendsGroupe
+ *
+ * @param nbOuvrier Nombre d'ouvriers (au moins 1), thread appelant compris
+ * @return Le groupe de threads, NULL si plus de mémoire
+ */
+PoolTaches *creePoolTaches(int nbOuvrier);
+
+/**
+ * @brief Initialise un groupe de tâches vide
+ */
+void initGroupe(GroupeTaches *groupe);
+
+/**
+ * @brief Lance une tâche, exécutée plus tard par un ouvrier
+ *
+ * @param pool Le groupe de threads
+ * @param groupe Le groupe de tâches auquel ajouter la tâche
+ * @param fonction La fonction à exécuter
+ * @param arg Son argument
+ */
+void lanceTache(PoolTaches *pool, GroupeTaches *groupe, void (*fonction)(void *), void *arg);
+
+/**
+ * @brief Attend la fin de toutes les tâches d'un groupe, y compris celles lancées entre-temps
+ * par ses tâches, en exécutant des tâches en attendant
+ *
+ * @param pool Le groupe de threads
+ * @param groupe Le groupe de tâches
+ */
+void attendsGroupe(PoolTaches *pool, GroupeTaches *groupe);
+
+/**
+ * @brief Renvoie le nombre d'ouvriers du groupe de threads
+ */
+int nbOuvriers(const PoolTaches *pool);
+
+/**
+ * @brief Arrête les threads et libère le groupe (aucune tâche ne doit rester en cours)
+ */
+void detruitPoolTaches(PoolTaches *pool);
+
+#endif